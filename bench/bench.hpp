@@ -0,0 +1,170 @@
+// Minimal self-contained benchmarking helpers (no external dependencies).
+//
+// Each benchmark is a single translation unit including this header:
+// it replaces the global operator new to count allocations.
+
+#ifndef _TC_BENCH_HPP_
+#define _TC_BENCH_HPP_
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <vector>
+
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+
+
+// ------------------------- allocations ------------------------- //
+
+static std::size_t bench_allocs = 0;
+
+void * operator new(std::size_t n) {
+    ++bench_allocs;
+    if (void * p = std::malloc(n ? n : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void * p) noexcept { std::free(p); }
+void operator delete(void * p, std::size_t) noexcept { std::free(p); }
+
+
+// --------------------------- helpers --------------------------- //
+
+// prevents the compiler from optimizing away a computed value
+template<class T>
+inline void bench_keep(T const & x) {
+    asm volatile("" : : "r,m"(x) : "memory");
+}
+
+// evicts the benchmarked data from the caches
+inline void bench_flush_cache() {
+    static std::vector<char> junk(64 << 20);
+    for (std::size_t i = 0; i < junk.size(); i += 64) {
+        junk[i]++;
+    }
+    bench_keep(junk[0]);
+}
+
+
+// ----------------------- branch misses ------------------------- //
+
+// A hardware counter of mispredicted branches. When perf events are
+// unavailable (non-Linux, containers, perf_event_paranoid) available()
+// is false and read() returns zero.
+struct bench_branch_misses {
+    int fd = -1;
+
+    bench_branch_misses() {
+#ifdef __linux__
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.size = sizeof(attr);
+        attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fd = (int)syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+#endif
+    }
+
+    ~bench_branch_misses() {
+#ifdef __linux__
+        if (fd >= 0) close(fd);
+#endif
+    }
+
+    bool available() const { return fd >= 0; }
+
+    void start() {
+#ifdef __linux__
+        if (fd < 0) return;
+        ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+#endif
+    }
+
+    std::uint64_t stop() {
+        std::uint64_t count = 0;
+#ifdef __linux__
+        if (fd < 0) return 0;
+        ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+        if (read(fd, &count, sizeof(count)) != sizeof(count)) count = 0;
+#endif
+        return count;
+    }
+};
+
+
+// --------------------------- timing ---------------------------- //
+
+struct bench_result {
+    double ns_per_op;
+    double allocs_per_op;
+    double misses_per_op; // negative if unavailable
+};
+
+// Runs `pass` (which performs `ops` operations) `reps` times, calling
+// `prepare` before each pass outside of the measured region.
+// The best pass is reported.
+template<class Prepare, class Pass>
+bench_result bench_run(std::size_t ops, int reps, Prepare prepare, Pass pass) {
+    static bench_branch_misses misses;
+
+    bench_result best = { 1e300, 0, -1 };
+
+    for (int r = 0; r < reps; r++) {
+        prepare();
+
+        std::size_t allocs = bench_allocs;
+        misses.start();
+        auto start = std::chrono::steady_clock::now();
+
+        pass();
+
+        auto stop = std::chrono::steady_clock::now();
+        std::uint64_t m = misses.stop();
+        allocs = bench_allocs - allocs;
+
+        double ns = std::chrono::duration<double, std::nano>(stop - start)
+            .count() / ops;
+
+        if (ns < best.ns_per_op) {
+            best.ns_per_op = ns;
+            best.allocs_per_op = double(allocs) / ops;
+            best.misses_per_op = misses.available() ? double(m) / ops : -1;
+        }
+    }
+
+    return best;
+}
+
+template<class Pass>
+bench_result bench_run(std::size_t ops, int reps, Pass pass) {
+    return bench_run(ops, reps, []{}, pass);
+}
+
+inline void bench_header() {
+    std::printf("%-40s %10s %10s %12s\n",
+        "benchmark", "ns/op", "allocs/op", "br-miss/op");
+}
+
+inline void bench_print(char const * name, bench_result r) {
+    if (r.misses_per_op < 0) {
+        std::printf("%-40s %10.2f %10.3f %12s\n",
+            name, r.ns_per_op, r.allocs_per_op, "n/a");
+    } else {
+        std::printf("%-40s %10.2f %10.3f %12.4f\n",
+            name, r.ns_per_op, r.allocs_per_op, r.misses_per_op);
+    }
+}
+
+#endif // _TC_BENCH_HPP_
@@ -0,0 +1,182 @@
+#!/bin/sh
+# Compile-time scaling benchmark for instance resolution.
+#
+# For every size NxM (N typeclasses times M instance types) a synthetic
+# translation unit is generated in each of the supported flavours:
+#
+#   tc            tc.hpp, TC_REQUIRE constraints                (C++14)
+#   tc_has        tc.hpp, tc_has_instance and TC_INSTANCE_IF    (C++14)
+#   alt           tc_alt.hpp, sizeof-based constraints          (C++14)
+#   alt_compat    tc_alt.hpp with TC_COMPAT, TC_REQUIRE         (C++14)
+#   concept       tc_concept.hpp, requires Instance<...>        (C++20)
+#   concept_dummy as concept, but with the former definition of Instance
+#                 instantiating _tc_dummy_<tc_impl_t<TC>>       (C++20)
+#
+# Every TU contains N*M explicit instances, a recursive instance
+# resolved DEPTH levels deep (Good<Foo<Foo<...>>> from constrained.cpp)
+# and a constraint check for every explicit instance.
+#
+# The result is a table (one row per flavour and size) with the compile
+# time, the peak memory of the compiler and the object file size.
+#
+# With CALLS=0 the methods are not called, so that only the cost of 
+# the constraint checks is measured.
+#
+# Environment: CXX, CONCEPT_CXX, FLAGS, CONCEPT_FLAGS, SIZES, DEPTH, FLAVOURS,
+#              CALLS
+
+CXX=${CXX:-g++}
+CONCEPT_CXX=${CONCEPT_CXX:-clang++}
+FLAGS=${FLAGS:--std=c++14}
+CONCEPT_FLAGS=${CONCEPT_FLAGS:--std=c++20}
+SIZES=${SIZES:-"10x10 20x50 40x100"}
+DEPTH=${DEPTH:-64}
+FLAVOURS=${FLAVOURS:-"tc tc_has alt alt_compat concept concept_dummy"}
+CALLS=${CALLS:-1}
+
+HERE=$(cd "$(dirname "$0")" && pwd)
+ROOT=$(dirname "$HERE")
+MEASURE=$HERE/measure
+WORK=${WORK:-$(mktemp -d)}
+
+# gen_tu FLAVOUR N M DEPTH
+gen_tu() {
+    flavour=$1; n=$2; m=$3; depth=$4
+
+    case $flavour in
+        tc|tc_has)  echo "#include \"$ROOT/tc.hpp\"" ;;
+        alt)        echo "#include \"$ROOT/tc_alt.hpp\"" ;;
+        alt_compat) echo "#define TC_COMPAT"
+                    echo "#include \"$ROOT/tc_alt.hpp\"" ;;
+        concept)    echo "#include \"$ROOT/tc_concept.hpp\"" ;;
+        concept_dummy)
+                    echo "#include \"$ROOT/tc.hpp\""
+                    echo "template<class TC>"
+                    echo "concept Instance = _tc_dummy_<tc_impl_t<TC>>::value;" ;;
+    esac
+
+    echo "template<class> struct Foo;"
+
+    j=0
+    while [ $j -lt $m ]; do echo "struct T$j {};"; j=$((j+1)); done
+
+    # typeclasses
+    i=0
+    while [ $i -lt $n ]; do
+        case $flavour in
+            alt*) echo "TC_DEF(C$i, class T, { static int f() = delete; });" ;;
+            *)    echo "template<class T> struct C$i { static int f() = delete; };" ;;
+        esac
+        i=$((i+1))
+    done
+
+    # explicit instances
+    i=0
+    while [ $i -lt $n ]; do
+        j=0
+        while [ $j -lt $m ]; do
+            case $flavour in
+                alt*) echo "template<> TC_INSTANCE(C$i, T$j, { static int f() { return $((i+j)); } });" ;;
+                *)    echo "template<> TC_INSTANCE(C$i<T$j>, { static int f() { return $((i+j)); } });" ;;
+            esac
+            j=$((j+1))
+        done
+        i=$((i+1))
+    done
+
+    # a recursive instance: C0 a => C0 (Foo a)
+    case $flavour in
+        tc)
+            echo "template<class T> TC_INSTANCE(C0<Foo<T>>, {"
+            echo "    TC_REQUIRE(C0<T>);"
+            echo "    static int f() { return tc_impl_t<C0<T>>::f() + 1; } });" ;;
+        tc_has)
+            echo "template<class T> TC_INSTANCE_IF(C0<Foo<T>>, tc_require_t<C0<T>>, {"
+            echo "    static int f() { return tc_impl_t<C0<T>>::f() + 1; } });" ;;
+        alt)
+            echo "template<class T> TC_INSTANCE(C0, Foo<T>, {"
+            echo "    static int f() { return C0<T>::f() + 1; } });" ;;
+        alt_compat)
+            echo "template<class T> TC_INSTANCE(C0, Foo<T>, {"
+            echo "    TC_REQUIRE(C0<T>);"
+            echo "    static int f() { return C0<T>::f() + 1; } });" ;;
+        concept*)
+            echo "template<class T> requires Instance<C0<T>>"
+            echo "TC_INSTANCE(C0<Foo<T>>, {"
+            echo "    static int f() { return tc_impl_t<C0<T>>::f() + 1; } });" ;;
+    esac
+
+    deep=T0; d=0
+    while [ $d -lt $depth ]; do deep="Foo<$deep>"; d=$((d+1)); done
+
+    echo "int use() {"
+    echo "    int s = 0;"
+    i=0
+    while [ $i -lt $n ]; do
+        j=0
+        while [ $j -lt $m ]; do
+            case $flavour in
+                tc|alt_compat) echo "    TC_REQUIRE(C$i<T$j>);" ;;
+                tc_has)        echo "    static_assert(tc_has_instance<C$i<T$j>>::value, \"\");" ;;
+                alt)           echo "    static_assert(sizeof(C$i<T$j>) != 0, \"\");" ;;
+                concept*)      echo "    static_assert(Instance<C$i<T$j>>);" ;;
+            esac
+            [ "$CALLS" = 0 ] && { j=$((j+1)); continue; }
+            case $flavour in
+                alt*) echo "    s += C$i<T$j>::f();" ;;
+                *)    echo "    s += tc_impl_t<C$i<T$j>>::f();" ;;
+            esac
+            j=$((j+1))
+        done
+        i=$((i+1))
+    done
+    case $flavour in
+        alt*) echo "    s += C0<$deep>::f();" ;;
+        *)    echo "    s += tc_impl_t<C0<$deep>>::f();" ;;
+    esac
+    echo "    return s;"
+    echo "}"
+}
+
+# run_one FLAVOUR COMPILER FLAGS N M
+run_one() {
+    flavour=$1; cxx=$2; flags=$3; n=$4; m=$5
+    src=$WORK/${flavour}_${n}x${m}.cpp
+    obj=$WORK/${flavour}_${n}x${m}.o
+
+    if ! command -v "$cxx" >/dev/null 2>&1; then
+        printf "%-13s %5s %5s %6s %10s %10s %10s\n" \
+            "$flavour" "$n" "$m" "$DEPTH" "n/a" "n/a" "n/a"
+        return
+    fi
+
+    gen_tu "$flavour" "$n" "$m" "$DEPTH" > "$src"
+
+    # shellcheck disable=SC2086
+    if res=$("$MEASURE" "$cxx" $flags -c "$src" -o "$obj" 2>"$src.log"); then
+        set -- $res
+        printf "%-13s %5s %5s %6s %10s %10s %10s\n" \
+            "$flavour" "$n" "$m" "$DEPTH" "$1" "$2" "$(wc -c < "$obj")"
+    else
+        printf "%-13s %5s %5s %6s %10s %10s %10s\n" \
+            "$flavour" "$n" "$m" "$DEPTH" "FAILED" "-" "-"
+        sed 's/^/    /' "$src.log" | head -20 >&2
+    fi
+}
+
+printf "# %s %s | %s %s | calls=%s\n" \
+    "$CXX" "$FLAGS" "$CONCEPT_CXX" "$CONCEPT_FLAGS" "$CALLS"
+printf "%-13s %5s %5s %6s %10s %10s %10s\n" \
+    "flavour" "N" "M" "depth" "ms" "peak_kb" "obj_bytes"
+
+for size in $SIZES; do
+    n=${size%x*}; m=${size#*x}
+    for flavour in $FLAVOURS; do
+        case $flavour in
+            concept*) run_one "$flavour" "$CONCEPT_CXX" "$CONCEPT_FLAGS" "$n" "$m" ;;
+            *)        run_one "$flavour" "$CXX"         "$FLAGS"         "$n" "$m" ;;
+        esac
+    done
+done
+
+[ -n "$KEEP" ] || rm -rf "$WORK"
@@ -0,0 +1,251 @@
+#include <string>
+#include <cstring>
+#include <cstdint>
+#include <functional>
+#include "../tc_derive.hpp"
+
+// Derived (TC_DERIVE) vs hand-written instances (-DHAND_WRITTEN) of
+// Eq, Ord, Show and Hash (see samples/derive.cpp). The check_* functions
+// must compile to the same code in both builds:
+//
+//     FLAGS_A=-DHAND_WRITTEN ./same_codegen.sh derive_codegen.cpp
+
+template<class T>
+struct Eq {
+    static bool equal(T const & a, T const & b) = delete;
+
+    static bool equal_n(T const * a, T const * b, size_t n) {
+        for (size_t i = 0; i < n; i++) {
+            if (!tc_impl_t<Eq<T>>::equal(a[i], b[i])) return false;
+        }
+        return true;
+    }
+};
+
+template<class T>
+struct Ord {
+    static int compare(T const & a, T const & b) = delete;
+};
+
+template<class T>
+struct Show {
+    static std::string show(T const & x) = delete;
+};
+
+template<class T>
+struct Hash {
+    static size_t hash(T const & x) = delete;
+};
+
+template<class T>
+struct BitwiseEq {};
+
+template<class T>
+using IsBitwiseEq = std::integral_constant<bool, tc_has_instance<BitwiseEq<T>>::value>;
+
+inline size_t hash_combine(size_t seed, size_t h) {
+    uint64_t x = seed * 0x9E3779B97F4A7C15ULL + h;
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    return size_t(x);
+}
+
+
+template<> TC_INSTANCE(Eq<int>, {
+    static bool equal(int const & a, int const & b) { return a == b; }
+});
+template<> TC_INSTANCE(Ord<int>, {
+    static int compare(int const & a, int const & b) { return (a > b) - (a < b); }
+});
+template<> TC_INSTANCE(Show<int>, {
+    static std::string show(int const & x) { return std::to_string(x); }
+});
+template<> TC_INSTANCE(Hash<int>, {
+    static size_t hash(int const & x) { return size_t(unsigned(x)); }
+});
+template<> TC_INSTANCE(BitwiseEq<int>, {});
+
+template<> TC_INSTANCE(Eq<std::string>, {
+    static bool equal(std::string const & a, std::string const & b) { return a == b; }
+});
+template<> TC_INSTANCE(Ord<std::string>, {
+    static int compare(std::string const & a, std::string const & b) {
+        int c = a.compare(b);
+        return (c > 0) - (c < 0);
+    }
+});
+template<> TC_INSTANCE(Hash<std::string>, {
+    static size_t hash(std::string const & x) { return std::hash<std::string>()(x); }
+});
+
+
+struct Point { int x, y; };
+struct Person { std::string name; int age; Point home; };
+
+
+#ifdef HAND_WRITTEN
+
+template<> TC_INSTANCE(Eq<Point>, {
+    static bool equal(Point const & a, Point const & b) {
+        return a.x == b.x && a.y == b.y;
+    }
+    static bool equal_n(Point const * a, Point const * b, size_t n) {
+        return n == 0 || std::memcmp(a, b, n * sizeof(Point)) == 0;
+    }
+});
+template<> TC_INSTANCE(Ord<Point>, {
+    static int compare(Point const & a, Point const & b) {
+        if (int c = tc_impl_t<Ord<int>>::compare(a.x, b.x)) return c;
+        return tc_impl_t<Ord<int>>::compare(a.y, b.y);
+    }
+});
+template<> TC_INSTANCE(Show<Point>, {
+    static std::string show(Point const & p) {
+        std::string res = "{";
+        res += "x";
+        res += " = ";
+        res += tc_impl_t<Show<int>>::show(p.x);
+        if (res.size() > 1) res += ", ";
+        res += "y";
+        res += " = ";
+        res += tc_impl_t<Show<int>>::show(p.y);
+        return res + "}";
+    }
+});
+template<> TC_INSTANCE(Hash<Point>, {
+    static size_t hash(Point const & p) {
+        size_t h = 0;
+        h = hash_combine(h, tc_impl_t<Hash<int>>::hash(p.x));
+        h = hash_combine(h, tc_impl_t<Hash<int>>::hash(p.y));
+        return h;
+    }
+});
+
+template<> TC_INSTANCE(Eq<Person>, {
+    static bool equal(Person const & a, Person const & b) {
+        return a.name == b.name && a.age == b.age
+            && tc_impl_t<Eq<Point>>::equal(a.home, b.home);
+    }
+});
+template<> TC_INSTANCE(Ord<Person>, {
+    static int compare(Person const & a, Person const & b) {
+        if (int c = tc_impl_t<Ord<std::string>>::compare(a.name, b.name)) return c;
+        if (int c = tc_impl_t<Ord<int>>::compare(a.age, b.age)) return c;
+        return tc_impl_t<Ord<Point>>::compare(a.home, b.home);
+    }
+});
+template<> TC_INSTANCE(Hash<Person>, {
+    static size_t hash(Person const & p) {
+        size_t h = 0;
+        h = hash_combine(h, tc_impl_t<Hash<std::string>>::hash(p.name));
+        h = hash_combine(h, tc_impl_t<Hash<int>>::hash(p.age));
+        h = hash_combine(h, tc_impl_t<Hash<Point>>::hash(p.home));
+        return h;
+    }
+});
+
+#else
+
+template<class T>
+struct tc_derived<Eq<T>>: Eq<T> {
+    static bool equal(T const & a, T const & b) {
+        return !tc_first_field2(a, b, [](auto const & x, auto const & y) {
+            return !tc_impl_t<Eq<std::decay_t<decltype(x)>>>::equal(x, y);
+        });
+    }
+
+    static bool equal_n(T const * a, T const * b, size_t n) {
+        return equal_n_(a, b, n, std::integral_constant<bool,
+            tc_fields_all<T, IsBitwiseEq>::value>());
+    }
+
+private:
+    static bool equal_n_(T const * a, T const * b, size_t n, std::true_type) {
+        return n == 0 || std::memcmp(a, b, n * sizeof(T)) == 0;
+    }
+
+    static bool equal_n_(T const * a, T const * b, size_t n, std::false_type) {
+        return Eq<T>::equal_n(a, b, n);
+    }
+};
+
+template<class T>
+struct tc_derived<Ord<T>>: Ord<T> {
+    static int compare(T const & a, T const & b) {
+        return tc_first_field2(a, b, [](auto const & x, auto const & y) {
+            return tc_impl_t<Ord<std::decay_t<decltype(x)>>>::compare(x, y);
+        });
+    }
+};
+
+template<class T>
+struct tc_derived<Show<T>>: Show<T> {
+    static std::string show(T const & x) {
+        std::string res = "{";
+        tc_each_field(x, [&](char const * name, auto const & f) {
+            if (res.size() > 1) res += ", ";
+            res += name;
+            res += " = ";
+            res += tc_impl_t<Show<std::decay_t<decltype(f)>>>::show(f);
+        });
+        return res + "}";
+    }
+};
+
+template<class T>
+struct tc_derived<Hash<T>>: Hash<T> {
+    static size_t hash(T const & x) {
+        size_t h = 0;
+        tc_each_field(x, [&](char const *, auto const & f) {
+            h = hash_combine(h, tc_impl_t<Hash<std::decay_t<decltype(f)>>>::hash(f));
+        });
+        return h;
+    }
+};
+
+TC_FIELDS(Point, x, y)
+TC_DERIVE(Point, Eq, Ord, Show, Hash)
+
+TC_FIELDS(Person, name, age, home)
+TC_DERIVE(Person, Eq, Ord, Hash)
+
+#endif
+
+
+extern "C" {
+
+bool check_eq_point(Point const & a, Point const & b) {
+    return tc_impl_t<Eq<Point>>::equal(a, b);
+}
+
+bool check_eq_points(Point const * a, Point const * b, size_t n) {
+    return tc_impl_t<Eq<Point>>::equal_n(a, b, n);
+}
+
+int check_compare_point(Point const & a, Point const & b) {
+    return tc_impl_t<Ord<Point>>::compare(a, b);
+}
+
+size_t check_hash_point(Point const & p) {
+    return tc_impl_t<Hash<Point>>::hash(p);
+}
+
+// Note: derived Show is not in the list. Its per-field lambda is
+// instantiated once per field type, and GCC keeps it out of line when
+// several fields share it, so the code differs from (but is smaller
+// than) the fully inlined hand-written version.
+
+bool check_eq_person(Person const & a, Person const & b) {
+    return tc_impl_t<Eq<Person>>::equal(a, b);
+}
+
+int check_compare_person(Person const & a, Person const & b) {
+    return tc_impl_t<Ord<Person>>::compare(a, b);
+}
+
+size_t check_hash_person(Person const & p) {
+    return tc_impl_t<Hash<Person>>::hash(p);
+}
+
+}
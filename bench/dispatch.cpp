@@ -0,0 +1,221 @@
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+#include "../tc_dyn.hpp"
+#include "bench.hpp"
+
+// Static dispatch through tc_impl_t vs the DynShow existentials from
+// samples/show.cpp vs the generated existentials of tc_dyn.hpp 
+// vs std::function.
+//
+// Two typeclasses are measured: the Show typeclass of show.cpp (the
+// result strings fit in the small string buffer, so no allocations
+// are expected) and a trivial Weight typeclass isolating the cost of
+// the dispatch itself.
+
+template<class T>
+struct Show {
+    static std::string show(T const &) = delete;
+};
+
+template<class T>
+struct Weight {
+    static long weight(T const &) = delete;
+};
+
+struct Foo { int x; };
+struct Bar { int x; };
+struct Baz { int x; };
+
+template<> TC_INSTANCE(Show<int>, {
+    static std::string show(int const & x) { return "int" + std::to_string(x); }
+});
+template<> TC_INSTANCE(Show<Foo>, {
+    static std::string show(Foo const &) { return "Foo"; }
+});
+template<> TC_INSTANCE(Show<Bar>, {
+    static std::string show(Bar const &) { return "Bar"; }
+});
+template<> TC_INSTANCE(Show<Baz>, {
+    static std::string show(Baz const &) { return "Baz"; }
+});
+
+template<> TC_INSTANCE(Weight<int>, {
+    static long weight(int const & x) { return x; }
+});
+template<> TC_INSTANCE(Weight<Foo>, {
+    static long weight(Foo const & x) { return x.x + 1; }
+});
+template<> TC_INSTANCE(Weight<Bar>, {
+    static long weight(Bar const & x) { return x.x * 2; }
+});
+template<> TC_INSTANCE(Weight<Baz>, {
+    static long weight(Baz const & x) { return x.x ^ 3; }
+});
+
+
+// existentials in the style of show.cpp
+struct DynBoth {
+    virtual std::string show_me() const = 0;
+    virtual long weight_me() const = 0;
+    virtual ~DynBoth() {}
+};
+
+template<class T>
+struct DynBothWrapper: DynBoth {
+    T self;
+
+    std::string show_me() const { return tc_impl_t<Show<T>>::show(self); }
+    long weight_me() const { return tc_impl_t<Weight<T>>::weight(self); }
+
+    DynBothWrapper(T x): self(x) {}
+};
+
+template<class T>
+std::unique_ptr<DynBoth> to_dyn_both(T x) {
+    return std::make_unique<DynBothWrapper<T>>(x);
+}
+
+// generated existentials
+#define SHOW_METHODS(m) m(show, std::string())
+#define WEIGHT_METHODS(m) m(weight, long())
+
+TC_DYN(Show, SHOW_METHODS)
+TC_DYN(Weight, WEIGHT_METHODS)
+
+// std::function equivalent
+struct Fns {
+    std::function<std::string()> show;
+    std::function<long()> weight;
+};
+
+template<class T>
+Fns to_fns(T x) {
+    return Fns {
+        [x]{ return tc_impl_t<Show<T>>::show(x); },
+        [x]{ return tc_impl_t<Weight<T>>::weight(x); }
+    };
+}
+
+
+// Builds the three containers over the same sequence of values.
+// With `kinds == 1` all the values are ints (a monomorphic call site),
+// otherwise the kinds are shuffled (a megamorphic call site).
+struct Data {
+    std::vector<int> ints;
+    std::vector<std::unique_ptr<DynBoth>> dyns;
+    std::vector<tc_dyn<Show>> dyn_shows;
+    std::vector<tc_dyn<Weight>> dyn_weights;
+    std::vector<Fns> fns;
+
+    template<class T>
+    void add(T x) {
+        dyns.push_back(to_dyn_both(x));
+        dyn_shows.push_back(to_dyn<Show>(x));
+        dyn_weights.push_back(to_dyn<Weight>(x));
+        fns.push_back(to_fns(x));
+    }
+
+    Data(std::size_t n, int kinds) {
+        std::mt19937 rng(42);
+        for (std::size_t i = 0; i < n; i++) {
+            int x = int(i % 100);
+            ints.push_back(x);
+            switch (kinds == 1 ? 0 : rng() % kinds) {
+                case 0: add(x); break;
+                case 1: add(Foo{x}); break;
+                case 2: add(Bar{x}); break;
+                default: add(Baz{x}); break;
+            }
+        }
+    }
+};
+
+void run(char const * label, std::size_t n, int passes, bool cold, int kinds) {
+    Data d(n, kinds);
+    std::size_t ops = n * passes;
+    auto prepare = [cold]{ if (cold) bench_flush_cache(); };
+    char name[64];
+
+    auto print = [&](char const * what, bench_result r) {
+        std::snprintf(name, sizeof(name), "%s %s", label, what);
+        bench_print(name, r);
+    };
+
+    if (kinds == 1) {
+        print("weight static", bench_run(ops, 5, prepare, [&]{
+            long s = 0;
+            for (int p = 0; p < passes; p++)
+                for (auto const & x : d.ints) s += tc_impl_t<Weight<int>>::weight(x);
+            bench_keep(s);
+        }));
+    }
+
+    print("weight DynShow", bench_run(ops, 5, prepare, [&]{
+        long s = 0;
+        for (int p = 0; p < passes; p++)
+            for (auto const & x : d.dyns) s += x->weight_me();
+        bench_keep(s);
+    }));
+
+    print("weight tc_dyn", bench_run(ops, 5, prepare, [&]{
+        long s = 0;
+        for (int p = 0; p < passes; p++)
+            for (auto const & x : d.dyn_weights) 
+                s += tc_impl_t<Weight<tc_dyn<Weight>>>::weight(x);
+        bench_keep(s);
+    }));
+
+    print("weight std::function", bench_run(ops, 5, prepare, [&]{
+        long s = 0;
+        for (int p = 0; p < passes; p++)
+            for (auto const & x : d.fns) s += x.weight();
+        bench_keep(s);
+    }));
+
+    if (kinds == 1) {
+        print("show static", bench_run(ops, 5, prepare, [&]{
+            std::size_t s = 0;
+            for (int p = 0; p < passes; p++)
+                for (auto const & x : d.ints) s += tc_impl_t<Show<int>>::show(x).size();
+            bench_keep(s);
+        }));
+    }
+
+    print("show DynShow", bench_run(ops, 5, prepare, [&]{
+        std::size_t s = 0;
+        for (int p = 0; p < passes; p++)
+            for (auto const & x : d.dyns) s += x->show_me().size();
+        bench_keep(s);
+    }));
+
+    print("show tc_dyn", bench_run(ops, 5, prepare, [&]{
+        std::size_t s = 0;
+        for (int p = 0; p < passes; p++)
+            for (auto const & x : d.dyn_shows) 
+                s += tc_impl_t<Show<tc_dyn<Show>>>::show(x).size();
+        bench_keep(s);
+    }));
+
+    print("show std::function", bench_run(ops, 5, prepare, [&]{
+        std::size_t s = 0;
+        for (int p = 0; p < passes; p++)
+            for (auto const & x : d.fns) s += x.show().size();
+        bench_keep(s);
+    }));
+}
+
+int main() {
+    bench_header();
+
+    // warm: a small container traversed many times
+    run("warm mono", 1 << 10, 1000, false, 1);
+    run("warm mega", 1 << 10, 1000, false, 4);
+
+    // cold: a large container traversed once after evicting the caches
+    run("cold mono", 1 << 20, 1, true, 1);
+    run("cold mega", 1 << 20, 1, true, 4);
+}
@@ -0,0 +1,189 @@
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+#include "../tc.hpp"
+#include "../samples/eq_dispatch.hpp"
+#include "bench.hpp"
+
+// Binary dispatch of Eq::equal(a, b) on two existentials: the compile-time
+// 2-D table of samples/eq_dispatch.hpp vs double virtual dispatch (the
+// visitor pattern in the style of DynShow) vs a virtual call and
+// a dynamic_cast.
+//
+// Values of different types are different (the fallback entry), so the
+// three give the same results.
+
+template<class T>
+struct Eq {
+    static bool equal(T const & a, T const & b) = delete;
+};
+
+struct Foo { int x; };
+struct Bar { int x; };
+
+template<> TC_INSTANCE(Eq<int>, {
+    static bool equal(int const & a, int const & b) { return a == b; }
+});
+template<> TC_INSTANCE(Eq<double>, {
+    static bool equal(double const & a, double const & b) { return a == b; }
+});
+template<> TC_INSTANCE(Eq<Foo>, {
+    static bool equal(Foo const & a, Foo const & b) { return a.x == b.x; }
+});
+template<> TC_INSTANCE(Eq<Bar>, {
+    static bool equal(Bar const & a, Bar const & b) { return a.x == b.x; }
+});
+
+// the entry for a pair of types
+template<class A, class B>
+struct EqualEntry {
+    static bool call(A const &, B const &) { return false; }
+};
+
+template<class A>
+struct EqualEntry<A, A> {
+    static bool call(A const & a, A const & b) { return tc_impl_t<Eq<A>>::equal(a, b); }
+};
+
+
+typedef Dyn<int, double, Foo, Bar> Value;
+
+
+// ----------------- double virtual dispatch (a visitor) ----------------- //
+
+struct DynEq {
+    // a.equal(b) calls b.equal_to(value of a)
+    virtual bool equal(DynEq const & other) const = 0;
+
+    virtual bool equal_to(int const & x) const = 0;
+    virtual bool equal_to(double const & x) const = 0;
+    virtual bool equal_to(Foo const & x) const = 0;
+    virtual bool equal_to(Bar const & x) const = 0;
+
+    virtual ~DynEq() {}
+};
+
+template<class T>
+struct DynEqWrapper: DynEq {
+    T self;
+
+    bool equal(DynEq const & other) const { return other.equal_to(self); }
+
+    bool equal_to(int const & x) const { return EqualEntry<int, T>::call(x, self); }
+    bool equal_to(double const & x) const { return EqualEntry<double, T>::call(x, self); }
+    bool equal_to(Foo const & x) const { return EqualEntry<Foo, T>::call(x, self); }
+    bool equal_to(Bar const & x) const { return EqualEntry<Bar, T>::call(x, self); }
+
+    DynEqWrapper(T x): self(x) {}
+};
+
+
+// ------------------- a virtual call and a dynamic_cast ------------------- //
+
+struct DynEqCast {
+    virtual bool equal(DynEqCast const & other) const = 0;
+    virtual ~DynEqCast() {}
+};
+
+template<class T>
+struct DynEqCastWrapper: DynEqCast {
+    T self;
+
+    bool equal(DynEqCast const & other) const {
+        auto p = dynamic_cast<DynEqCastWrapper const *>(&other);
+        return p && tc_impl_t<Eq<T>>::equal(self, p->self);
+    }
+
+    DynEqCastWrapper(T x): self(x) {}
+};
+
+
+// n pairs of values of `kinds` shuffled types (equal half of the time
+// when the types are the same)
+struct Data {
+    std::vector<Value> values;
+    std::vector<std::unique_ptr<DynEq>> visitors;
+    std::vector<std::unique_ptr<DynEqCast>> casts;
+
+    template<class T>
+    void add(T x) {
+        values.emplace_back(x);
+        visitors.push_back(std::make_unique<DynEqWrapper<T>>(x));
+        casts.push_back(std::make_unique<DynEqCastWrapper<T>>(x));
+    }
+
+    Data(std::size_t n, int kinds) {
+        std::mt19937 rng(42);
+        for (std::size_t i = 0; i < 2 * n; i++) {
+            int x = int(rng() % 2);
+            switch (kinds == 1 ? 0 : rng() % kinds) {
+                case 0: add(x); break;
+                case 1: add(double(x)); break;
+                case 2: add(Foo{x}); break;
+                default: add(Bar{x}); break;
+            }
+        }
+    }
+};
+
+void run(char const * label, std::size_t n, int passes, bool cold, int kinds) {
+    Data d(n, kinds);
+    std::size_t ops = n * passes;
+    auto prepare = [cold]{ if (cold) bench_flush_cache(); };
+    char name[64];
+
+    auto print = [&](char const * what, bench_result r) {
+        std::snprintf(name, sizeof(name), "%s %s", label, what);
+        bench_print(name, r);
+    };
+
+    std::size_t expected = 0, visitor = 0, cast = 0;
+
+    print("equal table", bench_run(ops, 5, prepare, [&]{
+        std::size_t s = 0;
+        for (int p = 0; p < passes; p++)
+            for (std::size_t i = 0; i < 2 * n; i += 2)
+                s += dispatch2<EqualEntry>(d.values[i], d.values[i + 1]);
+        bench_keep(s);
+        expected = s;
+    }));
+
+    print("equal double virtual", bench_run(ops, 5, prepare, [&]{
+        std::size_t s = 0;
+        for (int p = 0; p < passes; p++)
+            for (std::size_t i = 0; i < 2 * n; i += 2)
+                s += d.visitors[i]->equal(*d.visitors[i + 1]);
+        bench_keep(s);
+        visitor = s;
+    }));
+
+    print("equal dynamic_cast", bench_run(ops, 5, prepare, [&]{
+        std::size_t s = 0;
+        for (int p = 0; p < passes; p++)
+            for (std::size_t i = 0; i < 2 * n; i += 2)
+                s += d.casts[i]->equal(*d.casts[i + 1]);
+        bench_keep(s);
+        cast = s;
+    }));
+
+    if (visitor != expected || cast != expected) {
+        std::printf("%s: different results\n", label);
+        std::exit(1);
+    }
+}
+
+int main() {
+    bench_header();
+
+    // warm: a small container traversed many times
+    run("warm mono", 1 << 10, 1000, false, 1);
+    run("warm mega", 1 << 10, 1000, false, 4);
+
+    // cold: a large container traversed once after evicting the caches
+    run("cold mono", 1 << 20, 1, true, 1);
+    run("cold mega", 1 << 20, 1, true, 4);
+}
@@ -0,0 +1,128 @@
+#include <algorithm>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <string>
+#include <vector>
+#include "../tc_dyn.hpp"
+#include "../samples/show_arena.hpp"
+#include "bench.hpp"
+
+// Creation and teardown of a batch of 10^6 existentials (C++17):
+// DynShow boxes of samples/show.cpp (one unique_ptr each) vs tc_dyn
+// (one new each) vs tc_dyn_in in a batch owning its arena
+// (samples/show_arena.hpp), over std::pmr::monotonic_buffer_resource
+// and over a minimal bump arena.
+//
+// A third of the values have a non-trivial destructor (a short string,
+// so it doesn't allocate by itself).
+
+template<class T>
+struct Show {
+    static std::string show(T const &) = delete;
+};
+
+struct Foo { int x; };
+struct Name { std::string s; };
+
+template<> TC_INSTANCE(Show<int>, {
+    static std::string show(int const & x) { return "int" + std::to_string(x); }
+});
+template<> TC_INSTANCE(Show<Foo>, {
+    static std::string show(Foo const &) { return "Foo"; }
+});
+template<> TC_INSTANCE(Show<Name>, {
+    static std::string show(Name const & x) { return x.s; }
+});
+
+
+// existentials in the style of show.cpp
+struct DynShow {
+    virtual std::string show_me() const = 0;
+    virtual ~DynShow() {}
+};
+
+template<class T>
+struct DynShowWrapper: DynShow {
+    T self;
+
+    std::string show_me() const { return tc_impl_t<Show<T>>::show(self); }
+
+    DynShowWrapper(T x): self(std::move(x)) {}
+};
+
+template<class T>
+std::unique_ptr<DynShow> to_show(T x) {
+    return std::make_unique<DynShowWrapper<T>>(std::move(x));
+}
+
+#define SHOW_METHODS(m) m(show, std::string())
+
+TC_DYN(Show, SHOW_METHODS)
+
+
+// push(int), push(Foo) or push(Name) for the i-th value
+template<class Push>
+void fill(std::size_t n, Push push) {
+    for (std::size_t i = 0; i < n; i++) {
+        switch (i % 3) {
+            case 0: push(int(i)); break;
+            case 1: push(Foo{int(i)}); break;
+            default: push(Name{"name"}); break;
+        }
+    }
+}
+
+// Measures a whole batch (build + teardown) and its teardown only
+// (the batch is built in `prepare`, outside of the measured region).
+template<class Batch, class Build>
+void run(char const * label, std::size_t n, Build build) {
+    char name[64];
+
+    std::snprintf(name, sizeof(name), "%s build+drop", label);
+    bench_print(name, bench_run(n, 5, [&]{
+        Batch batch;
+        build(batch);
+        bench_keep(batch.size());
+    }));
+
+    std::optional<Batch> batch;
+    std::snprintf(name, sizeof(name), "%s drop", label);
+    bench_print(name, bench_run(n, 5,
+        [&]{ batch.emplace(); build(*batch); },
+        [&]{ batch.reset(); }));
+}
+
+int main() {
+    std::size_t const n = 1000000;
+
+    bench_header();
+
+    run<std::vector<std::unique_ptr<DynShow>>>("unique_ptr<DynShow>", n, [n](auto & xs) {
+        xs.reserve(n);
+        fill(n, [&](auto x) { xs.push_back(to_show(std::move(x))); });
+    });
+
+    run<std::vector<tc_dyn<Show>>>("tc_dyn", n, [n](auto & xs) {
+        xs.reserve(n);
+        fill(n, [&](auto x) { xs.push_back(to_dyn<Show>(std::move(x))); });
+    });
+
+    run<DynBatch<Show>>("DynBatch<pmr monotonic>", n, [n](auto & xs) {
+        xs.reserve(n);
+        fill(n, [&](auto x) { xs.push(std::move(x)); });
+    });
+
+    run<DynBatch<Show, Arena>>("DynBatch<Arena>", n, [n](auto & xs) {
+        xs.reserve(n);
+        fill(n, [&](auto x) { xs.push(std::move(x)); });
+    });
+
+    // all the paths give the same values
+    DynBatch<Show, Arena> batch;
+    std::vector<std::unique_ptr<DynShow>> boxes;
+    fill(3, [&](auto x) { boxes.push_back(to_show(x)); batch.push(x); });
+    for (std::size_t i = 0; i < 3; i++) {
+        if (boxes[i]->show_me() != tc_impl_t<Show<tc_dyn_in<Show>>>::show(batch[i])) return 1;
+    }
+}
@@ -0,0 +1,164 @@
+#include <string>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <assert.h>
+#include <unistd.h>
+#include "../samples/encode.hpp"
+#include "bench.hpp"
+
+// Throughput of the binary Encode/Decode typeclasses (see samples/encode.cpp)
+// vs the text Show path writing through the same buffered Writer:
+// per element, with the memcpy path for FixedSize elements and without it.
+//
+// Usage: ./encode [elements, 10^6 by default]
+
+
+// ------------------------------ Show ------------------------------ //
+
+template<class T>
+struct Show {
+    static void show(std::string & out, T const & x) = delete;
+};
+
+template<>
+TC_INSTANCE(Show<int>, {
+    static void show(std::string & out, int const & x) {
+        out += std::to_string(x);
+    }
+});
+
+template<>
+TC_INSTANCE(Show<double>, {
+    static void show(std::string & out, double const & x) {
+        char buf[32];
+        out.append(buf, size_t(std::snprintf(buf, sizeof(buf), "%.17g", x)));
+    }
+});
+
+template<class A, class B>
+TC_INSTANCE(TC(Show<std::pair<A, B>>), {
+    static void show(std::string & out, std::pair<A, B> const & x) {
+        out += '(';
+        tc_impl_t<Show<A>>::show(out, x.first);
+        out += ", ";
+        tc_impl_t<Show<B>>::show(out, x.second);
+        out += ')';
+    }
+});
+
+// the elements are flushed to the writer one by one
+// (cf. show_to in samples/show_sink.cpp)
+template<class T>
+void show_vector(Writer & w, std::vector<T> const & xs) {
+    std::string s;
+    w.write("[", 1);
+    for (size_t i = 0; i < xs.size(); i++) {
+        s.clear();
+        if (i > 0) s += ", ";
+        tc_impl_t<Show<T>>::show(s, xs[i]);
+        w.write(s.data(), s.size());
+    }
+    w.write("]", 1);
+}
+
+
+// ------------------------------------------------------------------ //
+
+static void print_header() {
+    std::printf("%-44s %10s %10s %12s\n", "benchmark", "ns/elem", "MB/s", "allocs/elem");
+}
+
+// bytes: the size of the output
+static void print(char const * label, char const * what, bench_result r, 
+                  size_t n, off_t bytes) {
+    char name[64];
+    std::snprintf(name, sizeof(name), "%s %s", label, what);
+    std::printf("%-44s %10.2f %10.1f %12.3f\n", name, r.ns_per_op,
+                double(bytes) / n / r.ns_per_op * 1e3, r.allocs_per_op);
+}
+
+// the output goes to a temporary file (i.e. to the page cache)
+static void rewind(int fd, bool truncate) {
+    if (truncate && ::ftruncate(fd, 0) != 0) std::abort();
+    ::lseek(fd, 0, SEEK_SET);
+}
+
+static off_t file_size(int fd) {
+    return ::lseek(fd, 0, SEEK_END);
+}
+
+template<class T>
+void run(char const * label, std::vector<T> const & xs, int fd) {
+    size_t n = xs.size();
+    bench_result r;
+
+    r = bench_run(n, 5, [&]{ rewind(fd, true); }, [&]{
+        Writer w(fd);
+        show_vector(w, xs);
+    });
+    print(label, "show", r, n, file_size(fd));
+
+    r = bench_run(n, 5, [&]{ rewind(fd, true); }, [&]{
+        Writer w(fd);
+        uint64_t size = n;
+        w.write(&size, sizeof(size));
+        encode_n(w, xs, std::false_type());
+    });
+    print(label, "encode per element", r, n, file_size(fd));
+
+    r = bench_run(n, 5, [&]{ rewind(fd, true); }, [&]{
+        Writer w(fd);
+        tc_impl_t<Encode<std::vector<T>>>::encode(w, xs);
+    });
+    off_t bytes = file_size(fd);
+    print(label, "encode", r, n, bytes);
+
+    // the results are checked after the measurements
+    std::vector<T> ys;
+    bool ok = false;
+    r = bench_run(n, 5, [&]{ rewind(fd, false); }, [&]{
+        Reader in(fd);
+        uint64_t size;
+        ok = in.read(&size, sizeof(size)) && size == n;
+        ys.resize(n);
+        ok = ok && decode_n(in, ys, 0, n, std::false_type());
+        bench_keep(ok);
+    });
+    assert(ok && ys == xs);
+    print(label, "decode per element", r, n, bytes);
+
+    ys.clear();
+    ok = false;
+    r = bench_run(n, 5, [&]{ rewind(fd, false); }, [&]{
+        Reader in(fd);
+        ok = tc_impl_t<Decode<std::vector<T>>>::decode(in, ys);
+        bench_keep(ok);
+    });
+    assert(ok && ys == xs);
+    print(label, "decode", r, n, bytes);
+}
+
+int main(int argc, char ** argv) {
+    size_t n = argc > 1 ? size_t(std::atoll(argv[1])) : 1000000;
+
+    std::FILE * file = std::tmpfile();
+    int fd = fileno(file);
+
+    std::vector<int> xs(n);
+    for (size_t i = 0; i < n; i++) xs[i] = int(i * 2654435761u);
+
+    std::vector<std::pair<int, double>> ps(n);
+    for (size_t i = 0; i < n; i++) ps[i] = { int(i), double(i) / 3 };
+
+    print_header();
+    run("vector<int>", xs, fd);
+    run("vector<pair<int,double>>", ps, fd);
+
+    std::fclose(file);
+}
@@ -0,0 +1,58 @@
+#include <vector>
+#include "../samples/eq_bitwise.hpp"
+#include "bench.hpp"
+
+// Eq/Ord of contiguous containers: the element-wise scalar path vs 
+// the memcmp/SIMD kernels selected for BitwiseEq element types 
+// (see samples/eq_bitwise.hpp). Build with -mavx2 for the AVX2 kernel.
+
+template<class T>
+void run(char const * label, std::vector<T> const & a, std::vector<T> const & b) {
+    std::size_t n = a.size();
+    char name[64];
+    bool eq = false;
+    int ord = 0;
+
+    std::snprintf(name, sizeof(name), "%s equal scalar", label);
+    bench_print(name, bench_run(n, 20, [&]{
+        eq = a.size() == b.size() && equal_n(a.data(), b.data(), n, std::false_type());
+        bench_keep(eq);
+    }));
+
+    std::snprintf(name, sizeof(name), "%s equal bitwise", label);
+    bench_print(name, bench_run(n, 20, [&]{
+        eq = tc_impl_t<Eq<std::vector<T>>>::equal(a, b);
+        bench_keep(eq);
+    }));
+
+    std::snprintf(name, sizeof(name), "%s compare scalar", label);
+    bench_print(name, bench_run(n, 20, [&]{
+        std::size_t i = mismatch_n(a.data(), b.data(), n, std::false_type());
+        ord = i < n ? tc_impl_t<Ord<T>>::compare(a[i], b[i]) : 0;
+        bench_keep(ord);
+    }));
+
+    std::snprintf(name, sizeof(name), "%s compare bitwise", label);
+    bench_print(name, bench_run(n, 20, [&]{
+        ord = tc_impl_t<Ord<std::vector<T>>>::compare(a, b);
+        bench_keep(ord);
+    }));
+}
+
+int main() {
+    std::size_t const n = 1 << 20;
+
+    std::vector<int> a(n), b;
+    for (std::size_t i = 0; i < n; i++) a[i] = int(i * 7);
+    b = a;
+    b.back()++; // differ at the very end: a full scan in both paths
+
+    std::vector<std::pair<int, int>> pa(n), pb;
+    for (std::size_t i = 0; i < n; i++) pa[i] = { int(i), int(i * 3) };
+    pb = pa;
+    pb.back().second++;
+
+    bench_header();
+    run("vector<int>", a, b);
+    run("vector<pair<int,int>>", pa, pb);
+}
@@ -0,0 +1,150 @@
+#include <optional>
+#include <string>
+#include <utility>
+#include <variant>
+#include <vector>
+#include <random>
+#include "../samples/expected.hpp"
+#include "bench.hpp"
+
+// The failure-heavy path: a chain parse -> parse -> divide -> +1 over
+// inputs of which 0% to 100% are invalid, with errors as values
+// (Monad<Result> and Monad<std::optional> of samples/expected.hpp)
+// vs the same chain throwing and catching an exception (C++17).
+//
+// Note: the C++ runtime allocates the exception objects with malloc,
+// so they don't appear in the allocs/op column.
+
+// --------------------------- the three versions --------------------------- //
+
+// the parser returns the error code, or 0 and the value
+__attribute__((noinline))
+int parse(char const * s, int & out) {
+    if (!*s) return 1 + int(Errc::empty);
+
+    bool negative = *s == '-';
+    if (negative) s++;
+
+    long long x = 0;
+    for (; *s; s++) {
+        if (*s < '0' || *s > '9') return 1 + int(Errc::not_a_number);
+        x = x * 10 + (*s - '0');
+        if (x > 2147483647LL) return 1 + int(Errc::overflow);
+    }
+    out = int(negative ? -x : x);
+    return 0;
+}
+
+char const * const messages[] = { "empty", "not a number", "overflow", "division by zero" };
+
+Result<int> parse_result(char const * s) {
+    int x;
+    if (int e = parse(s, x)) return unexpected(Error{ Errc(e - 1), messages[e - 1] });
+    return x;
+}
+
+Result<int> divide_result(int a, int b) {
+    if (b == 0) return unexpected(Error{ Errc::division_by_zero, messages[3] });
+    return a / b;
+}
+
+std::optional<int> parse_optional(char const * s) {
+    int x;
+    if (parse(s, x)) return std::nullopt;
+    return x;
+}
+
+std::optional<int> divide_optional(int a, int b) {
+    if (b == 0) return std::nullopt;
+    return a / b;
+}
+
+// an exception class without a std::string (so no operator new)
+struct ParseError {
+    Error error;
+};
+
+int parse_throw(char const * s) {
+    int x;
+    if (int e = parse(s, x)) throw ParseError{ Error{ Errc(e - 1), messages[e - 1] } };
+    return x;
+}
+
+int divide_throw(int a, int b) {
+    if (b == 0) throw ParseError{ Error{ Errc::division_by_zero, messages[3] } };
+    return a / b;
+}
+
+template<template<class> class M, class Parse, class Div>
+M<int> ratio_plus_one(char const * a, char const * b, Parse parse, Div div) {
+    TC_IMPL(Monad<M>) MM;
+    TC_IMPL(Functor<M>) FM;
+
+    return FM::fmap(MM::bind(parse(a), [&](int x) {
+        return MM::bind(parse(b), [&](int y) {
+            return div(x, y);
+        });
+    }), [](int r) { return r + 1; });
+}
+
+int ratio_plus_one_throw(char const * a, char const * b) {
+    return divide_throw(parse_throw(a), parse_throw(b)) + 1;
+}
+
+
+void run(int percent_bad, std::size_t n) {
+    char const * good[] = { "84", "-12", "2", "1000" };
+    char const * bad[] = { "x84", "", "99999999999", "0" }; // "0" fails at the division
+
+    std::mt19937 rng(42);
+    std::vector<std::pair<char const *, char const *>> inputs;
+    for (std::size_t i = 0; i < n; i++) {
+        bool fails = int(rng() % 100) < percent_bad;
+        inputs.emplace_back(good[rng() % 4], fails ? bad[rng() % 4] : good[rng() % 4]);
+    }
+
+    char name[64];
+    long long expected = 0, got = 0;
+
+    std::snprintf(name, sizeof(name), "%3d%% errors: throw/catch", percent_bad);
+    bench_print(name, bench_run(n, 5, [&]{
+        long long s = 0;
+        for (auto const & in : inputs) {
+            try {
+                s += ratio_plus_one_throw(in.first, in.second);
+            } catch (ParseError const & e) {
+                s -= int(e.error.code);
+            }
+        }
+        bench_keep(s);
+        expected = s;
+    }));
+
+    std::snprintf(name, sizeof(name), "%3d%% errors: Monad<Result>", percent_bad);
+    bench_print(name, bench_run(n, 5, [&]{
+        long long s = 0;
+        for (auto const & in : inputs) {
+            Result<int> r = ratio_plus_one<Result>(in.first, in.second, parse_result, divide_result);
+            s += r ? *r : -int(r.error().code);
+        }
+        bench_keep(s);
+        got = s;
+    }));
+    if (got != expected) std::exit(1);
+
+    std::snprintf(name, sizeof(name), "%3d%% errors: Monad<std::optional>", percent_bad);
+    bench_print(name, bench_run(n, 5, [&]{
+        long long s = 0;
+        for (auto const & in : inputs) {
+            std::optional<int> r = ratio_plus_one<std::optional>(in.first, in.second, parse_optional, divide_optional);
+            s += r ? *r : -1;
+        }
+        bench_keep(s);
+    }));
+}
+
+int main() {
+    bench_header();
+
+    for (int percent_bad : { 0, 10, 50, 100 }) run(percent_bad, 1 << 16);
+}
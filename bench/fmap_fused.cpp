@@ -0,0 +1,94 @@
+#include <cstdlib>
+#include <memory>
+#include <utility>
+#include <vector>
+#include <type_traits>
+#include "../samples/functor_lazy.hpp"
+#include "bench.hpp"
+
+// A pipeline of 4 fmaps, a filter and a fold over 10^7 ints:
+// the eager Functor<Vec> of samples/functor.cpp (a new vector per step,
+// or the buffer reused for rvalues mapped to the same type) vs the lazy
+// pipelines of samples/functor_lazy.hpp (a single pass).
+//
+// Usage: ./fmap_fused [elements]
+
+// --------------------- the eager instances (functor.cpp) --------------------- //
+
+template<>
+TC_INSTANCE(Functor<Vec>, {
+    template<class A, class F>
+    static auto fmap(Vec<A> const & xs, F f) -> Vec<decltype(f(std::declval<A const &>()))> {
+        Vec<decltype(f(std::declval<A const &>()))> res;
+        res.reserve(xs.size());
+        for (auto const & x : xs) res.push_back(f(x));
+        return res;
+    }
+
+    template<class A, class F,
+             class = typename std::enable_if<
+                 std::is_same<decltype(std::declval<F &>()(std::declval<A>())), A>::value
+             >::type>
+    static Vec<A> fmap(Vec<A> && xs, F f) {
+        for (auto && x : xs) x = f(std::move(x)); // auto &&: vector<bool>
+        return std::move(xs);
+    }
+});
+
+template<class A, class P>
+Vec<A> filter(Vec<A> const & xs, P p) {
+    Vec<A> res;
+    for (auto const & x : xs) if (p(x)) res.push_back(x);
+    return res;
+}
+
+
+// the steps of the pipeline
+auto const f1 = [](long long x) { return x * 3; };
+auto const f2 = [](long long x) { return x + 7; };
+auto const f3 = [](long long x) { return x ^ (x >> 3); };
+auto const f4 = [](long long x) { return x % 1000; };
+auto const keep = [](long long x) { return x % 3 != 0; };
+auto const add = [](long long acc, long long x) { return acc + x; };
+
+int main(int argc, char ** argv) {
+    std::size_t n = argc > 1 ? std::size_t(std::atoll(argv[1])) : 10000000;
+
+    TC_IMPL(Functor<Vec>) FV;
+    TC_IMPL(Functor<Lazy>) FL;
+
+    Vec<long long> xs(n);
+    for (std::size_t i = 0; i < n; i++) xs[i] = (long long)(i * 2654435761u % 100000);
+
+    long long expected = 0;
+
+    bench_header();
+
+    bench_print("eager (a vector per step)", bench_run(n, 5, [&]{
+        auto ys = filter(FV::fmap(FV::fmap(FV::fmap(FV::fmap(xs, f1), f2), f3), f4), keep);
+        expected = tc_impl_t<Foldable<Vec>>::fold_left(ys, 0LL, add);
+        bench_keep(expected);
+    }));
+
+    bench_print("eager (buffer reused)", bench_run(n, 5, [&]{
+        // a single copy, then mapped in place
+        auto ys = FV::fmap(FV::fmap(FV::fmap(FV::fmap(Vec<long long>(xs), f1), f2), f3), f4);
+        long long s = tc_impl_t<Foldable<Vec>>::fold_left(filter(ys, keep), 0LL, add);
+        if (s != expected) std::exit(1);
+        bench_keep(s);
+    }));
+
+    Vec<long long> collected;
+    bench_print("lazy collect (one vector)", bench_run(n, 5, [&]{
+        collected = collect(filter(FL::fmap(FL::fmap(FL::fmap(FL::fmap(lazy(xs), f1), f2), f3), f4), keep));
+        bench_keep(collected.data());
+    }));
+    if (tc_impl_t<Foldable<Vec>>::fold_left(collected, 0LL, add) != expected) return 1;
+
+    bench_print("lazy fold (no vector)", bench_run(n, 5, [&]{
+        auto ys = filter(FL::fmap(FL::fmap(FL::fmap(FL::fmap(lazy(xs), f1), f2), f3), f4), keep);
+        long long s = tc_impl_t<Foldable<Lazy>>::fold_left(ys, 0LL, add);
+        if (s != expected) std::exit(1);
+        bench_keep(s);
+    }));
+}
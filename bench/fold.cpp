@@ -0,0 +1,44 @@
+#include <cstdlib>
+#include <thread>
+#include <algorithm>
+#include <assert.h>
+#include "../samples/monoid.hpp"
+#include "bench.hpp"
+
+// Throughput of Foldable<Vec>::fold_map vs par_fold_map (see 
+// samples/monoid.hpp) for 1 to N threads.
+//
+// Usage: ./fold [max threads] [elements, 10^8 by default]
+
+int main(int argc, char ** argv) {
+    unsigned max_threads = argc > 1 ? unsigned(std::atoi(argv[1])) 
+                                    : std::max(1u, std::thread::hardware_concurrency());
+    std::size_t n = argc > 2 ? std::size_t(std::atoll(argv[2])) : 100000000;
+
+    TC_IMPL(Foldable<Vec>) FV;
+
+    Vec<int> xs(n);
+    for (std::size_t i = 0; i < n; i++) xs[i] = int(i % 1000);
+
+    auto g = [](int x) { return (long long)x; };
+    long long expected = FV::fold_map(xs, g);
+
+    bench_result seq = bench_run(n, 3, [&]{
+        bench_keep(FV::fold_map(xs, g));
+    });
+
+    std::printf("%8s %10s %12s %10s\n", "threads", "ns/elem", "Melem/s", "speedup");
+    std::printf("%8s %10.3f %12.1f %10.2f\n", "seq", seq.ns_per_op, 
+                1e3 / seq.ns_per_op, 1.0);
+
+    for (unsigned t = 1; t <= max_threads; t++) {
+        bench_result par = bench_run(n, 3, [&]{
+            long long s = FV::par_fold_map(xs, g, t);
+            assert(s == expected);
+            bench_keep(s);
+        });
+
+        std::printf("%8u %10.3f %12.1f %10.2f\n", t, par.ns_per_op, 
+                    1e3 / par.ns_per_op, seq.ns_per_op / par.ns_per_op);
+    }
+}
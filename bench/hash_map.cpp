@@ -0,0 +1,67 @@
+#include <utility>
+#include <vector>
+#include <random>
+#include <unordered_map>
+#include "../samples/hash_map.hpp"
+#include "bench.hpp"
+
+// FlatMap (see samples/hash_map.cpp) vs std::unordered_map
+// with int keys: insertion, successful and unsuccessful lookups.
+
+// the same hash function for both tables
+struct IntHash {
+    std::size_t operator()(int x) const { return tc_impl_t<Hash<int>>::hash(x); }
+};
+
+int main() {
+    std::size_t const n = 1 << 20;
+
+    std::vector<int> keys(n), missing(n);
+    std::mt19937 rng(1);
+    for (std::size_t i = 0; i < n; i++) {
+        keys[i] = int(rng() & 0x7FFFFFFF);
+        missing[i] = -1 - int(rng() & 0x7FFFFFFF);
+    }
+
+    bench_header();
+
+    bench_print("insert FlatMap", bench_run(n, 5, [&]{
+        FlatMap<int, int> m;
+        for (int k : keys) m.emplace(k, k);
+        bench_keep(m.size());
+    }));
+
+    bench_print("insert std::unordered_map", bench_run(n, 5, [&]{
+        std::unordered_map<int, int, IntHash> m;
+        for (int k : keys) m.emplace(k, k);
+        bench_keep(m.size());
+    }));
+
+    FlatMap<int, int> flat;
+    std::unordered_map<int, int, IntHash> unordered;
+    for (int k : keys) { flat.emplace(k, k); unordered.emplace(k, k); }
+
+    bench_print("find hit FlatMap", bench_run(n, 5, [&]{
+        long s = 0;
+        for (int k : keys) s += *flat.find(k);
+        bench_keep(s);
+    }));
+
+    bench_print("find hit std::unordered_map", bench_run(n, 5, [&]{
+        long s = 0;
+        for (int k : keys) s += unordered.find(k)->second;
+        bench_keep(s);
+    }));
+
+    bench_print("find miss FlatMap", bench_run(n, 5, [&]{
+        long s = 0;
+        for (int k : missing) s += flat.find(k) != nullptr;
+        bench_keep(s);
+    }));
+
+    bench_print("find miss std::unordered_map", bench_run(n, 5, [&]{
+        long s = 0;
+        for (int k : missing) s += unordered.find(k) != unordered.end();
+        bench_keep(s);
+    }));
+}
@@ -0,0 +1,110 @@
+#include <string>
+#include <vector>
+#include "tc.hpp"
+
+// Instances with probes (TC_INSTANCE_PROBED and TC_PROBE, see
+// tc_instrument.hpp) compiled without TC_INSTRUMENT vs the same file
+// compiled with the headers of before the instrumentation (baseline/),
+// where the instances are plain TC_INSTANCEs. The check_* functions
+// must compile to the same code:
+//
+//     FLAGS_A=-I.. FLAGS_B=-Ibaseline ./same_codegen.sh instrument_codegen.cpp
+
+// the baseline has no probes
+#ifndef TC_PROBE
+#define TC_PROBE()
+#define TC_INSTANCE_PROBED(tc, methods, body...) TC_INSTANCE(TC(tc), body)
+#endif
+
+template<class T>
+struct Eq {
+    static bool equal(T const & a, T const & b) = delete;
+};
+
+template<class T>
+struct Show {
+    static std::string show(T const & x) = delete;
+};
+
+template<class T>
+struct Monoid {
+    static T empty() = delete;
+    static T append(T const & a, T const & b) = delete;
+};
+
+#define EQ_METHODS(m) m(equal, bool(T const &))
+#define MONOID_METHODS(m) m(empty, T()) m(append, T(T const &))
+
+template<> TC_INSTANCE_PROBED(Eq<int>, EQ_METHODS, {
+    static bool equal(int const & a, int const & b) {
+        return a == b;
+    }
+});
+
+template<> TC_INSTANCE(Show<int>, {
+    static std::string show(int const & x) {
+        TC_PROBE();
+        return std::to_string(x);
+    }
+});
+
+template<> TC_INSTANCE_PROBED(Monoid<long>, MONOID_METHODS, {
+    static long empty() {
+        return 0;
+    }
+    static long append(long const & a, long const & b) {
+        return a + b;
+    }
+});
+
+// not probed
+template<> TC_INSTANCE(Monoid<int>, {
+    static int empty() {
+        return 0;
+    }
+    static int append(int const & a, int const & b) {
+        return a + b;
+    }
+});
+
+template<class T>
+TC_INSTANCE_PROBED(Eq<std::vector<T>>, EQ_METHODS, {
+    static bool equal(std::vector<T> const & a, std::vector<T> const & b) {
+        if (a.size() != b.size()) return false;
+        for (std::size_t i = 0; i < a.size(); i++) {
+            if (!tc_impl_t<Eq<T>>::equal(a[i], b[i])) return false;
+        }
+        return true;
+    }
+});
+
+
+extern "C" {
+
+bool check_eq_int(int a, int b) {
+    return tc_impl_t<Eq<int>>::equal(a, b);
+}
+
+bool check_eq_vector(std::vector<int> const & a, std::vector<int> const & b) {
+    return tc_impl_t<Eq<std::vector<int>>>::equal(a, b);
+}
+
+std::size_t check_show_int(int x) {
+    return tc_impl_t<Show<int>>::show(x).size();
+}
+
+long check_sum(long const * xs, std::size_t n) {
+    TC_IMPL(Monoid<long>) M;
+    long acc = M::empty();
+    for (std::size_t i = 0; i < n; i++) acc = M::append(acc, xs[i]);
+    return acc;
+}
+
+int check_sum_int(int const * xs, std::size_t n) {
+    TC_IMPL(Monoid<int>) M;
+    int acc = M::empty();
+    for (std::size_t i = 0; i < n; i++) acc = M::append(acc, xs[i]);
+    return acc;
+}
+
+}
@@ -0,0 +1,42 @@
+// Runs a command and reports its wall time and the peak resident set
+// size of the child process (i.e. of the compiler).
+//
+// Usage: ./measure cmd args...
+// Output: <milliseconds> <peak kilobytes>
+
+#include <cstdio>
+#include <chrono>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <sys/resource.h>
+
+int main(int argc, char ** argv) {
+    if (argc < 2) {
+        std::fprintf(stderr, "usage: %s cmd args...\n", argv[0]);
+        return 2;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    pid_t pid = fork();
+    if (pid == 0) {
+        execvp(argv[1], argv + 1);
+        std::perror(argv[1]);
+        _exit(127);
+    }
+
+    int status = 0;
+    struct rusage usage {};
+    if (pid < 0 || wait4(pid, &status, 0, &usage) < 0) {
+        std::perror("measure");
+        return 2;
+    }
+
+    auto stop = std::chrono::steady_clock::now();
+    long ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        stop - start).count();
+
+    std::printf("%ld %ld\n", ms, usage.ru_maxrss); // ru_maxrss is in KB
+
+    return WIFEXITED(status) ? WEXITSTATUS(status) : 1;
+}
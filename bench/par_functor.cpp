@@ -0,0 +1,40 @@
+#include <cmath>
+#include <cstdlib>
+#include <thread>
+#include <algorithm>
+#include "../samples/par_functor.hpp"
+#include "bench.hpp"
+
+// Scaling of ParFunctor<Vec>::par_fmap (see samples/par_functor.cpp) 
+// from 1 to N threads.
+//
+// Usage: ./par_functor [max threads] [elements]
+
+int main(int argc, char ** argv) {
+    unsigned max_threads = argc > 1 ? unsigned(std::atoi(argv[1])) 
+                                    : std::max(1u, std::thread::hardware_concurrency());
+    std::size_t n = argc > 2 ? std::size_t(std::atoll(argv[2])) : 10000000;
+
+    Vec<double> xs(n);
+    for (std::size_t i = 0; i < n; i++) xs[i] = double(i % 1000);
+
+    auto f = [](double x) { return std::sqrt(x) * std::sin(x); };
+
+    bench_result seq = bench_run(n, 3, [&]{
+        bench_keep(tc_impl_t<Functor<Vec>>::fmap(xs, f).back());
+    });
+
+    std::printf("%8s %10s %10s\n", "threads", "ns/elem", "speedup");
+    std::printf("%8s %10.3f %10.2f\n", "seq", seq.ns_per_op, 1.0);
+
+    for (unsigned t = 1; t <= max_threads; t++) {
+        ThreadPool pool(t);
+        ParPolicy policy{pool, 1 << 14};
+
+        bench_result par = bench_run(n, 3, [&]{
+            bench_keep(tc_impl_t<ParFunctor<Vec>>::par_fmap(policy, xs, f).back());
+        });
+
+        std::printf("%8u %10.3f %10.2f\n", t, par.ns_per_op, seq.ns_per_op / par.ns_per_op);
+    }
+}
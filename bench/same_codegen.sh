@@ -0,0 +1,54 @@
+#!/bin/sh
+# Checks that two builds of a translation unit generate the same code.
+#
+# Usage: same_codegen.sh SRC_A [SRC_B]
+#
+# SRC_A is compiled with FLAGS_A and SRC_B (SRC_A by default) with
+# FLAGS_B. The assembly of every function named check_* (declared
+# extern "C" so that the names are the same) is compared after
+# renumbering the local labels. The exit status is 1 if some function
+# differs or is missing.
+#
+# Environment: CXX, FLAGS (-std=c++14 -O2 by default), FLAGS_A, FLAGS_B
+
+CXX=${CXX:-g++}
+FLAGS=${FLAGS:--std=c++14 -O2}
+SRC_A=$1
+SRC_B=${2:-$1}
+WORK=${WORK:-$(mktemp -d)}
+
+# functions SRC FLAGS OUT: the normalized check_* functions of SRC
+functions() {
+    # shellcheck disable=SC2086
+    "$CXX" $FLAGS $2 -S -fno-asynchronous-unwind-tables "$1" -o "$3.s" || exit 1
+    awk '
+        /^check_[A-Za-z0-9_]*:/          { name = $1; print; next }
+        name && /^[ \t]*\.size[ \t]/     { name = ""; print ""; next }
+        name && !/^[ \t]*\.(cfi_|loc|file|globl)/ {
+            gsub(/\.L[A-Za-z]*[0-9]+/, ".L")
+            print
+        }
+    ' "$3.s" > "$3"
+}
+
+functions "$SRC_A" "$FLAGS_A" "$WORK/a"
+functions "$SRC_B" "$FLAGS_B" "$WORK/b"
+
+status=0
+for f in $(grep -h '^check_' "$WORK/a" "$WORK/b" | sort -u); do
+    name=${f%:}
+    awk -v f="$f" '$1 == f { p = 1 } p { print } p && /^$/ { exit }' "$WORK/a" > "$WORK/fa"
+    awk -v f="$f" '$1 == f { p = 1 } p { print } p && /^$/ { exit }' "$WORK/b" > "$WORK/fb"
+
+    if [ ! -s "$WORK/fa" ] || [ ! -s "$WORK/fb" ]; then
+        printf "%-32s %s\n" "$name" "MISSING"; status=1
+    elif cmp -s "$WORK/fa" "$WORK/fb"; then
+        printf "%-32s %s (%s lines)\n" "$name" "same" "$(wc -l < "$WORK/fa")"
+    else
+        printf "%-32s %s\n" "$name" "DIFFERENT"; status=1
+        diff "$WORK/fa" "$WORK/fb" | sed 's/^/    /' | head -40
+    fi
+done
+
+[ -n "$KEEP" ] || rm -rf "$WORK"
+exit $status
@@ -0,0 +1,200 @@
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+#include "../tc_dyn.hpp"
+#include "bench.hpp"
+
+// Speculative devirtualization (tc_speculate_t of tc_dyn.hpp) vs the
+// virtual calls of the DynShow style and the indirect calls of tc_dyn,
+// on a skewed distribution of types (95% of ints, the rest spread over
+// three other types) and on a uniform one (where the guess is right
+// 25% of the time). The speculation is always on int, with and without
+// a tc_dyn_site counting the hits and misses.
+//
+// The containers are small and traversed many times, so the branch
+// predictor learns the sequence of types: the indirect calls are
+// cheaper than with random types in a cold container.
+
+template<class T>
+struct Show {
+    static std::string show(T const &) = delete;
+};
+
+template<class T>
+struct Weight {
+    static long weight(T const &) = delete;
+};
+
+struct Foo { int x; };
+struct Bar { int x; };
+struct Baz { int x; };
+
+template<> TC_INSTANCE(Show<int>, {
+    static std::string show(int const & x) { return "int" + std::to_string(x); }
+});
+template<> TC_INSTANCE(Show<Foo>, {
+    static std::string show(Foo const &) { return "Foo"; }
+});
+template<> TC_INSTANCE(Show<Bar>, {
+    static std::string show(Bar const &) { return "Bar"; }
+});
+template<> TC_INSTANCE(Show<Baz>, {
+    static std::string show(Baz const &) { return "Baz"; }
+});
+
+template<> TC_INSTANCE(Weight<int>, {
+    static long weight(int const & x) { return x; }
+});
+template<> TC_INSTANCE(Weight<Foo>, {
+    static long weight(Foo const & x) { return x.x + 1; }
+});
+template<> TC_INSTANCE(Weight<Bar>, {
+    static long weight(Bar const & x) { return x.x * 2; }
+});
+template<> TC_INSTANCE(Weight<Baz>, {
+    static long weight(Baz const & x) { return x.x ^ 3; }
+});
+
+
+// existentials in the style of show.cpp
+struct DynBoth {
+    virtual std::string show_me() const = 0;
+    virtual long weight_me() const = 0;
+    virtual ~DynBoth() {}
+};
+
+template<class T>
+struct DynBothWrapper: DynBoth {
+    T self;
+
+    std::string show_me() const { return tc_impl_t<Show<T>>::show(self); }
+    long weight_me() const { return tc_impl_t<Weight<T>>::weight(self); }
+
+    DynBothWrapper(T x): self(x) {}
+};
+
+template<class T>
+std::unique_ptr<DynBoth> to_dyn_both(T x) {
+    return std::make_unique<DynBothWrapper<T>>(x);
+}
+
+// generated existentials
+#define SHOW_METHODS(m) m(show, std::string())
+#define WEIGHT_METHODS(m) m(weight, long())
+
+TC_DYN(Show, SHOW_METHODS)
+TC_DYN(Weight, WEIGHT_METHODS)
+
+
+// `percent_int` of the values are ints, the rest Foo, Bar or Baz
+struct Data {
+    std::vector<std::unique_ptr<DynBoth>> dyns;
+    std::vector<tc_dyn<Show>> dyn_shows;
+    std::vector<tc_dyn<Weight>> dyn_weights;
+
+    template<class T>
+    void add(T x) {
+        dyns.push_back(to_dyn_both(x));
+        dyn_shows.push_back(to_dyn<Show>(x));
+        dyn_weights.push_back(to_dyn<Weight>(x));
+    }
+
+    Data(std::size_t n, int percent_int) {
+        std::mt19937 rng(42);
+        for (std::size_t i = 0; i < n; i++) {
+            int x = int(i % 100);
+            if (int(rng() % 100) < percent_int) {
+                add(x);
+                continue;
+            }
+            switch (rng() % 3) {
+                case 0: add(Foo{x}); break;
+                case 1: add(Bar{x}); break;
+                default: add(Baz{x}); break;
+            }
+        }
+    }
+};
+
+void run(char const * label, int percent_int) {
+    std::size_t n = 1 << 10;
+    int passes = 1000;
+    std::size_t ops = n * passes;
+    Data d(n, percent_int);
+    char name[64];
+
+    auto print = [&](char const * what, bench_result r) {
+        std::snprintf(name, sizeof(name), "%s %s", label, what);
+        bench_print(name, r);
+    };
+
+    long expected = 0, got = 0;
+
+    print("weight DynShow", bench_run(ops, 5, [&]{
+        long s = 0;
+        for (int p = 0; p < passes; p++)
+            for (auto const & x : d.dyns) s += x->weight_me();
+        bench_keep(s);
+        expected = s;
+    }));
+
+    print("weight tc_dyn", bench_run(ops, 5, [&]{
+        long s = 0;
+        for (int p = 0; p < passes; p++)
+            for (auto const & x : d.dyn_weights)
+                s += tc_impl_t<Weight<tc_dyn<Weight>>>::weight(x);
+        bench_keep(s);
+    }));
+
+    print("weight speculated", bench_run(ops, 5, [&]{
+        long s = 0;
+        for (int p = 0; p < passes; p++)
+            for (auto const & x : d.dyn_weights)
+                s += tc_speculate_t<Weight, int>::weight(x);
+        bench_keep(s);
+        got = s;
+    }));
+    if (got != expected) std::exit(1);
+
+    tc_dyn_site site("weight");
+    print("weight speculated + site", bench_run(ops, 5, [&]{
+        long s = 0;
+        for (int p = 0; p < passes; p++)
+            for (auto const & x : d.dyn_weights)
+                s += tc_speculate_t<Weight, int>::weight(site, x);
+        bench_keep(s);
+    }));
+
+    print("show DynShow", bench_run(ops, 5, [&]{
+        std::size_t s = 0;
+        for (int p = 0; p < passes; p++)
+            for (auto const & x : d.dyns) s += x->show_me().size();
+        bench_keep(s);
+    }));
+
+    print("show tc_dyn", bench_run(ops, 5, [&]{
+        std::size_t s = 0;
+        for (int p = 0; p < passes; p++)
+            for (auto const & x : d.dyn_shows)
+                s += tc_impl_t<Show<tc_dyn<Show>>>::show(x).size();
+        bench_keep(s);
+    }));
+
+    print("show speculated", bench_run(ops, 5, [&]{
+        std::size_t s = 0;
+        for (int p = 0; p < passes; p++)
+            for (auto const & x : d.dyn_shows)
+                s += tc_speculate_t<Show, int>::show(x).size();
+        bench_keep(s);
+    }));
+
+    site.report(stdout);
+}
+
+int main() {
+    bench_header();
+
+    run("skewed", 95);
+    run("uniform", 25);
+}
@@ -0,0 +1,131 @@
+#!/bin/sh
+# Clean-build time of K translation units sharing tc_std.hpp.
+#
+# Every generated TU defines a user type with Show and Eq instances and
+# uses the standard instances (as main.cpp does). The TUs are compiled
+# to object files one by one, in each of the flavours:
+#
+#   textual     #include "tc_std.hpp"                          (C++14, CXX)
+#   pch         as textual, with tc_std.hpp precompiled once   (C++14, CXX)
+#   textual20   as textual                                     (C++20, CONCEPT_CXX)
+#   module      import tc; with tc.pcm built once              (C++20, CONCEPT_CXX)
+#
+# The time of a flavour includes the time of building the precompiled
+# header or the module. textual20 is the baseline for module (both use
+# the same compiler).
+#
+# Environment: CXX, CONCEPT_CXX, FLAGS, CONCEPT_FLAGS, COUNTS, FLAVOURS
+
+CXX=${CXX:-g++}
+CONCEPT_CXX=${CONCEPT_CXX:-clang++}
+FLAGS=${FLAGS:--std=c++14}
+CONCEPT_FLAGS=${CONCEPT_FLAGS:--std=c++20}
+COUNTS=${COUNTS:-"10 50"}
+FLAVOURS=${FLAVOURS:-"textual pch textual20 module"}
+
+HERE=$(cd "$(dirname "$0")" && pwd)
+ROOT=$(dirname "$HERE")
+MEASURE=$ROOT/bench/measure
+WORK=${WORK:-$(mktemp -d)}
+
+[ -x "$MEASURE" ] || make -s -C "$ROOT/bench" measure || exit 1
+
+# gen_tu FLAVOUR I
+gen_tu() {
+    flavour=$1; i=$2
+
+    case $flavour in
+        module) echo "import tc;"
+                echo "#include \"$ROOT/tc_macros.hpp\"" ;;
+        *)      echo "#include \"tc_std.hpp\"" ;;
+    esac
+    cat <<TU
+#include <string>
+#include <vector>
+#include <utility>
+
+struct P$i { int x, y; };
+
+template<>
+TC_INSTANCE(Show<P$i>, {
+    static std::string show(P$i const & p) {
+        return tc_impl_t<Show<std::pair<int, int>>>::show({p.x, p.y});
+    }
+});
+
+template<>
+TC_INSTANCE(Eq<P$i>, {
+    static bool equal(P$i const & p, P$i const & q) {
+        return p.x == q.x && p.y == q.y;
+    }
+});
+
+std::string use$i(std::vector<std::pair<int, std::string>> const & xs) {
+    std::vector<P$i> ps = tc_impl_t<Functor<Vec>>::fmap(
+        std::vector<int>{1, 2, 3}, [](int k) { return P$i{k, k}; });
+    bool same = tc_impl_t<Eq<std::vector<P$i>>>::equal(ps, ps);
+    return tc_impl_t<Show<std::vector<P$i>>>::show(ps) 
+         + tc_impl_t<Show<std::vector<std::pair<int, std::string>>>>::show(xs)
+         + (same ? "" : "!");
+}
+TU
+}
+
+# build_script FLAVOUR K: the shell commands of a clean build
+build_script() {
+    flavour=$1; k=$2; dir=$WORK/$flavour
+    case $flavour in
+        textual)   cxx=$CXX;         flags="$FLAGS -I$HERE" ;;
+        pch)       cxx=$CXX;         flags="$FLAGS -I$dir -I$HERE -Winvalid-pch" 
+                   echo "$cxx $FLAGS -x c++-header $HERE/tc_std.hpp -o $dir/tc_std.hpp.gch" ;;
+        textual20) cxx=$CONCEPT_CXX; flags="$CONCEPT_FLAGS -I$HERE" ;;
+        module)    cxx=$CONCEPT_CXX; flags="$CONCEPT_FLAGS -fprebuilt-module-path=$dir"
+                   echo "$cxx $flags --precompile $HERE/tc-std_instances.cppm -o $dir/tc-std_instances.pcm"
+                   echo "$cxx $flags --precompile $HERE/tc.cppm -o $dir/tc.pcm"
+                   echo "$cxx $flags -c $dir/tc-std_instances.pcm -o $dir/tc-std_instances.o"
+                   echo "$cxx $flags -c $dir/tc.pcm -o $dir/tc.o" ;;
+    esac
+    i=0
+    while [ $i -lt $k ]; do
+        echo "$cxx $flags -c $dir/tu$i.cpp -o $dir/tu$i.o"
+        i=$((i+1))
+    done
+}
+
+# run_one FLAVOUR K
+run_one() {
+    flavour=$1; k=$2; dir=$WORK/$flavour
+    case $flavour in
+        textual|pch) cxx=$CXX ;;
+        *)           cxx=$CONCEPT_CXX ;;
+    esac
+
+    if ! command -v "$cxx" >/dev/null 2>&1; then
+        printf "%-10s %5s %10s %10s\n" "$flavour" "$k" "n/a" "n/a"
+        return
+    fi
+
+    rm -rf "$dir"; mkdir -p "$dir"
+    i=0
+    while [ $i -lt $k ]; do gen_tu "$flavour" $i > "$dir/tu$i.cpp"; i=$((i+1)); done
+    { echo "set -e"; build_script "$flavour" "$k"; } > "$dir/build.sh"
+
+    if res=$("$MEASURE" sh "$dir/build.sh" 2>"$dir/build.log"); then
+        set -- $res
+        printf "%-10s %5s %10s %10s\n" "$flavour" "$k" "$1" "$(($1 / k))"
+    else
+        printf "%-10s %5s %10s %10s\n" "$flavour" "$k" "FAILED" "-"
+        sed 's/^/    /' "$dir/build.log" | head -20 >&2
+    fi
+}
+
+printf "# %s %s | %s %s\n" "$CXX" "$FLAGS" "$CONCEPT_CXX" "$CONCEPT_FLAGS"
+printf "%-10s %5s %10s %10s\n" "flavour" "TUs" "ms" "ms_per_tu"
+
+for k in $COUNTS; do
+    for flavour in $FLAVOURS; do
+        run_one "$flavour" "$k"
+    done
+done
+
+[ -n "$KEEP" ] || rm -rf "$WORK"
@@ -0,0 +1,62 @@
+// the shared header goes first: a precompiled header is used only then
+#ifdef TC_USE_MODULE
+import tc;
+#include "../tc_macros.hpp"
+#else
+#include "tc_std.hpp"
+#endif
+
+#include <iostream>
+#include <cassert>
+#include <string>
+#include <vector>
+#include <memory>
+#include <utility>
+
+// a user type with user instances on top of the shared ones
+struct Point { int x, y; };
+
+template<>
+TC_INSTANCE(Show<Point>, {
+    static std::string show(Point const & p) {
+        return "Point" + tc_impl_t<Show<std::pair<int, int>>>::show({p.x, p.y});
+    }
+});
+
+template<>
+TC_INSTANCE(Eq<Point>, {
+    static bool equal(Point const & p, Point const & q) {
+        return p.x == q.x && p.y == q.y;
+    }
+});
+
+template<class T>
+std::string show(T const & x) {
+    TC_REQUIRE(Show<T>)
+    return tc_impl_t<Show<T>>::show(x);
+}
+
+template<class T>
+bool equal(T const & x, T const & y) {
+    TC_REQUIRE(Eq<T>)
+    return tc_impl_t<Eq<T>>::equal(x, y);
+}
+
+int main() {
+    std::vector<std::pair<int, std::string>> xs = {{1, "one"}, {2, "two"}};
+    std::cout << show(xs) << std::endl;
+
+    std::vector<Point> ps = tc_impl_t<Functor<Vec>>::fmap(
+        std::vector<int>{1, 2, 3}, [](int i) { return Point{i, i * i}; }
+    );
+    std::cout << show(ps) << std::endl;
+    assert(equal(ps, ps));
+    assert(!equal(ps, std::vector<Point>{}));
+
+    std::unique_ptr<int> p(new int(42)), q;
+    std::cout << show(p) << " " << show(q) << std::endl;
+    assert(!equal(p, q));
+
+    static_assert(tc_has_instance<Show<std::vector<Point>>>::value, "");
+    static_assert(!tc_has_instance<Eq<double>>::value, "");
+}
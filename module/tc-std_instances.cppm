@@ -0,0 +1,15 @@
+// The partition tc:std_instances: the typeclasses of tc_std.hpp 
+// together with their instances for the standard types.
+//
+// Instances are specializations of _tc_impl_, so they are reachable 
+// from any importer of the module which names the primary template.
+
+module;
+#include "tc_std.hpp"
+
+export module tc:std_instances;
+
+export using ::Show;
+export using ::Eq;
+export using ::Functor;
+export using ::Vec;
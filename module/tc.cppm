@@ -0,0 +1,18 @@
+// The module tc: the core templates of tc.hpp and tc_concept.hpp
+// plus the standard instances (the partition tc:std_instances).
+//
+// Macros can't be exported: after `import tc;` include ../tc_macros.hpp.
+
+module;
+#include "../tc_concept.hpp"
+
+export module tc;
+
+export import :std_instances;
+
+export using ::_tc_impl_;
+export using ::tc_impl_t;
+export using ::_tc_dummy_;
+export using ::tc_has_instance;
+export using ::tc_require_t;
+export using ::Instance;
@@ -0,0 +1,146 @@
+// Shared typeclasses with instances for standard types.
+//
+// This is the header that every translation unit would otherwise re-parse:
+// it can be precompiled (make main_pch) or wrapped into the partition 
+// tc:std_instances of the module tc (make modules).
+
+#ifndef _TC_STD_HPP_
+#define _TC_STD_HPP_
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <utility>
+#include <type_traits>
+#include "../tc.hpp"
+
+
+template<class T>
+struct Show {
+    static std::string show(T const &) = delete;
+};
+
+template<class T>
+struct Eq {
+    static bool equal(T const &, T const &) = delete;
+};
+
+// T has the kind * -> *
+template<template<class> class T>
+struct Functor {
+    template<class A, class F>
+    static auto fmap(T<A> const & xs, F f) -> T<decltype(f(std::declval<A>()))> 
+    = delete;
+};
+
+// a "higher-kinded" vector with the default allocator
+template<class T> using Vec = std::vector<T>;
+
+
+// Show int
+template<>
+TC_INSTANCE(Show<int>, {
+    static std::string show(int const & x) {
+        return std::to_string(x);
+    }
+});
+
+// Show string
+template<>
+TC_INSTANCE(Show<std::string>, {
+    static std::string show(std::string const & x) {
+        return '"' + x + '"';
+    }
+});
+
+// (Show a, Show b) => Show (a, b)
+template<class A, class B>
+TC_INSTANCE(TC(Show<std::pair<A, B>>), {
+    static std::string show(std::pair<A, B> const & x) {
+        return "(" + tc_impl_t<Show<A>>::show(x.first) + ", " 
+                   + tc_impl_t<Show<B>>::show(x.second) + ")";
+    }
+});
+
+// Show a => Show [a]
+template<class T>
+TC_INSTANCE(Show<std::vector<T>>, {
+    static std::string show(std::vector<T> const & xs) {
+        std::string res = "[";
+        for (size_t i = 0; i < xs.size(); i++) {
+            if (i > 0) res += ", ";
+            res += tc_impl_t<Show<T>>::show(xs[i]);
+        }
+        return res + "]";
+    }
+});
+
+// Show a => Show (unique_ptr a)
+template<class T>
+TC_INSTANCE(Show<std::unique_ptr<T>>, {
+    static std::string show(std::unique_ptr<T> const & x) {
+        return x ? "&" + tc_impl_t<Show<T>>::show(*x) : "null";
+    }
+});
+
+
+// Eq int
+template<>
+TC_INSTANCE(Eq<int>, {
+    static bool equal(int const & x, int const & y) { return x == y; }
+});
+
+// Eq string
+template<>
+TC_INSTANCE(Eq<std::string>, {
+    static bool equal(std::string const & x, std::string const & y) { 
+        return x == y; 
+    }
+});
+
+// (Eq a, Eq b) => Eq (a, b)
+template<class A, class B>
+TC_INSTANCE(TC(Eq<std::pair<A, B>>), {
+    static bool equal(std::pair<A, B> const & x, std::pair<A, B> const & y) {
+        return tc_impl_t<Eq<A>>::equal(x.first, y.first) 
+            && tc_impl_t<Eq<B>>::equal(x.second, y.second);
+    }
+});
+
+// Eq a => Eq [a]
+template<class T>
+TC_INSTANCE(Eq<std::vector<T>>, {
+    static bool equal(std::vector<T> const & xs, std::vector<T> const & ys) {
+        if (xs.size() != ys.size()) return false;
+        for (size_t i = 0; i < xs.size(); i++) {
+            if (!tc_impl_t<Eq<T>>::equal(xs[i], ys[i])) return false;
+        }
+        return true;
+    }
+});
+
+// Eq a => Eq (unique_ptr a)
+template<class T>
+TC_INSTANCE(Eq<std::unique_ptr<T>>, {
+    static bool equal(std::unique_ptr<T> const & x, 
+                      std::unique_ptr<T> const & y) {
+        if (!x || !y) return !x && !y;
+        return tc_impl_t<Eq<T>>::equal(*x, *y);
+    }
+});
+
+
+// Functor Vec
+template<>
+TC_INSTANCE(Functor<Vec>, {
+    template<class A, class F>
+    static auto fmap(Vec<A> const & xs, F f) -> Vec<decltype(f(std::declval<A>()))> {
+        decltype(fmap(xs,f)) res;
+        res.reserve(xs.size());
+        for (auto const & x: xs) res.push_back(f(x));
+        return res;
+    }
+});
+
+
+#endif // _TC_STD_HPP_
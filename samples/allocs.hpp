@@ -0,0 +1,22 @@
+// Counting the allocations of a sample: the global operator new is
+// replaced, so this header is included by a single translation unit.
+
+#ifndef _ALLOCS_HPP_
+#define _ALLOCS_HPP_
+
+#include <cstdlib>
+#include <new>
+
+static std::size_t allocs = 0;
+
+void * operator new(std::size_t n) {
+    allocs++;
+    // malloc(0) may return null
+    if (void * p = std::malloc(n ? n : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void * p) noexcept { std::free(p); }
+void operator delete(void * p, std::size_t) noexcept { std::free(p); }
+
+#endif // _ALLOCS_HPP_
@@ -0,0 +1,256 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <list>
+#include <iterator>
+#include <cstring>
+#include <cassert>
+#include <type_traits>
+#include "../tc.hpp"
+
+// Bulk (batched) typeclass methods.
+//
+// A typeclass may declare methods working on many values at once.
+// Their defaults loop over the scalar methods, while instances may
+// override them with batched implementations. Generic code can check
+// at compile time whether an instance overrides a method (TC_OVERRIDES)
+// and choose an algorithm accordingly.
+//
+// A scalar method and its bulk counterpart are defined through each
+// other, so (as in default.cpp) an instance must define at least one
+// of them: the defaults check this with a static_assert.
+
+template<class T>
+struct Show {
+    static constexpr bool complete() {
+        return TC_OVERRIDES(show, Show<T>) || TC_OVERRIDES(show_many, Show<T>);
+    }
+
+    static std::string show(T const & x) {
+        static_assert(complete(), "Show: define show or show_many");
+        std::string res;
+        tc_impl_t<Show<T>>::show_many(&x, 1, res);
+        return res;
+    }
+
+    // appends the values separated by ", " to out
+    static void show_many(T const * xs, size_t n, std::string & out) {
+        static_assert(complete(), "Show: define show or show_many");
+        for (size_t i = 0; i < n; i++) {
+            if (i > 0) out += ", ";
+            out += tc_impl_t<Show<T>>::show(xs[i]);
+        }
+    }
+};
+
+template<class T>
+struct Eq {
+    static constexpr bool complete() {
+        return TC_OVERRIDES(equal, Eq<T>) || TC_OVERRIDES(equal_n, Eq<T>);
+    }
+
+    static bool equal(T const & x, T const & y) {
+        static_assert(complete(), "Eq: define equal or equal_n");
+        return tc_impl_t<Eq<T>>::equal_n(&x, &y, 1);
+    }
+
+    static bool equal_n(T const * xs, T const * ys, size_t n) {
+        static_assert(complete(), "Eq: define equal or equal_n");
+        for (size_t i = 0; i < n; i++) {
+            if (!tc_impl_t<Eq<T>>::equal(xs[i], ys[i])) return false;
+        }
+        return true;
+    }
+};
+
+
+// writes the decimal digits of x to p, returns the end
+inline char * format_int(int x, char * p) {
+    unsigned u = x < 0 ? 0u - unsigned(x) : unsigned(x);
+    if (x < 0) *p++ = '-';
+
+    char buf[10];
+    int k = 0;
+    do { buf[k++] = char('0' + u % 10); u /= 10; } while (u);
+    while (k) *p++ = buf[--k];
+    return p;
+}
+
+// Show int: both methods, the bulk one formats into a single buffer
+template<>
+TC_INSTANCE(Show<int>, {
+    static std::string show(int const & x) {
+        return std::to_string(x);
+    }
+
+    static void show_many(int const * xs, size_t n, std::string & out) {
+        size_t pos = out.size();
+        out.resize(pos + n * 13); // "-2147483648, "
+
+        char * p = &out[pos];
+        for (size_t i = 0; i < n; i++) {
+            if (i > 0) { *p++ = ','; *p++ = ' '; }
+            p = format_int(xs[i], p);
+        }
+        out.resize(p - &out[0]);
+    }
+});
+
+// Eq int: the bulk method compares the bytes
+template<>
+TC_INSTANCE(Eq<int>, {
+    static bool equal(int const & x, int const & y) {
+        return x == y;
+    }
+
+    static bool equal_n(int const * xs, int const * ys, size_t n) {
+        return n == 0 || std::memcmp(xs, ys, n * sizeof(int)) == 0;
+    }
+});
+
+
+struct Point { int x, y; };
+
+// Show Point, Eq Point: only the scalar methods
+template<>
+TC_INSTANCE(Show<Point>, {
+    static std::string show(Point const & p) {
+        return "(" + std::to_string(p.x) + ", " + std::to_string(p.y) + ")";
+    }
+});
+
+template<>
+TC_INSTANCE(Eq<Point>, {
+    static bool equal(Point const & p, Point const & q) {
+        return p.x == q.x && p.y == q.y;
+    }
+});
+
+
+struct Byte { unsigned char b; };
+
+// Show Byte, Eq Byte: only the bulk methods (a hex dump and memcmp)
+template<>
+TC_INSTANCE(Show<Byte>, {
+    static void show_many(Byte const * xs, size_t n, std::string & out) {
+        static char const digits[] = "0123456789abcdef";
+        for (size_t i = 0; i < n; i++) {
+            if (i > 0) out += ' ';
+            out += digits[xs[i].b >> 4];
+            out += digits[xs[i].b & 15];
+        }
+    }
+});
+
+template<>
+TC_INSTANCE(Eq<Byte>, {
+    static bool equal_n(Byte const * xs, Byte const * ys, size_t n) {
+        return n == 0 || std::memcmp(xs, ys, n) == 0;
+    }
+});
+
+
+// Show a => Show [a], Eq a => Eq [a]: a contiguous container
+// always goes through the bulk methods (by default they just loop)
+template<class T>
+TC_INSTANCE(Show<std::vector<T>>, {
+    static std::string show(std::vector<T> const & xs) {
+        std::string res = "[";
+        tc_impl_t<Show<T>>::show_many(xs.data(), xs.size(), res);
+        return res + "]";
+    }
+});
+
+template<class T>
+TC_INSTANCE(Eq<std::vector<T>>, {
+    static bool equal(std::vector<T> const & xs, std::vector<T> const & ys) {
+        return xs.size() == ys.size()
+            && tc_impl_t<Eq<T>>::equal_n(xs.data(), ys.data(), xs.size());
+    }
+});
+
+
+// A generic algorithm over any range: copying chunks of a non-contiguous
+// range into a buffer pays off only if show_many is really batched,
+// so the path is chosen by TC_OVERRIDES.
+
+static int bulk_chunks = 0;
+
+template<class It>
+void show_range_(It first, It last, std::string & out, std::false_type) {
+    typedef typename std::iterator_traits<It>::value_type T;
+    for (It it = first; it != last; ++it) {
+        if (it != first) out += ", ";
+        out += tc_impl_t<Show<T>>::show(*it);
+    }
+}
+
+template<class It>
+void show_range_(It first, It last, std::string & out, std::true_type) {
+    typedef typename std::iterator_traits<It>::value_type T;
+    size_t const chunk = 64;
+    std::vector<T> buf;
+    buf.reserve(chunk);
+
+    for (It it = first; it != last; ) {
+        if (it != first) out += ", ";
+
+        buf.clear();
+        for (; it != last && buf.size() < chunk; ++it) buf.push_back(*it);
+
+        tc_impl_t<Show<T>>::show_many(buf.data(), buf.size(), out);
+        bulk_chunks++;
+    }
+}
+
+template<class It>
+std::string show_range(It first, It last) {
+    typedef typename std::iterator_traits<It>::value_type T;
+    std::integral_constant<bool, TC_OVERRIDES(show_many, Show<T>)> bulk;
+
+    std::string res = "[";
+    show_range_(first, last, res, bulk);
+    return res + "]";
+}
+
+
+// struct Nope {};
+// template<> TC_INSTANCE(Show<Nope>, {}) // compiles, but using
+//                                        // tc_impl_t<Show<Nope>>::show
+//                                        // won't: "Show: define show or show_many"
+
+int main() {
+    static_assert(TC_OVERRIDES(show_many, Show<int>), "");
+    static_assert(!TC_OVERRIDES(show_many, Show<Point>), "");
+    static_assert(!TC_OVERRIDES(show, Show<Byte>), "");
+
+    std::vector<int> xs = {1, -20, 300, -2147483647 - 1};
+    std::vector<Point> ps = {{1, 2}, {3, 4}};
+    std::vector<Byte> bs = {{0x0a}, {0xff}, {0x42}};
+
+    std::cout << tc_impl_t<Show<std::vector<int>>>::show(xs) << std::endl;
+    std::cout << tc_impl_t<Show<std::vector<Point>>>::show(ps) << std::endl;
+    std::cout << tc_impl_t<Show<std::vector<Byte>>>::show(bs) << std::endl;
+    std::cout << tc_impl_t<Show<Byte>>::show(bs[0]) << std::endl;
+
+    assert(tc_impl_t<Show<std::vector<int>>>::show(xs)
+           == "[1, -20, 300, -2147483648]");
+    assert(tc_impl_t<Show<Byte>>::show(bs[1]) == "ff");
+
+    assert(tc_impl_t<Eq<std::vector<int>>>::equal(xs, xs));
+    assert(!tc_impl_t<Eq<std::vector<Point>>>::equal(ps, {{1, 2}, {3, 5}}));
+    assert(tc_impl_t<Eq<Byte>>::equal(bs[0], Byte{0x0a}));
+    assert(!tc_impl_t<Eq<Byte>>::equal(bs[0], bs[1]));
+
+    // ints are copied into chunks and shown in bulk, points one by one
+    std::list<int> xl;
+    for (int i = 0; i < 100; i++) xl.push_back(i);
+    std::list<Point> pl(ps.begin(), ps.end());
+
+    std::string s = show_range(xl.begin(), xl.end());
+    assert(bulk_chunks == 2);
+    assert(s.substr(0, 10) == "[0, 1, 2, " && s.substr(s.size() - 7) == "98, 99]");
+
+    std::cout << show_range(pl.begin(), pl.end()) << std::endl;
+    assert(bulk_chunks == 2);
+}
@@ -8,20 +8,32 @@
 // our typeclass implementation implicitly uses a sort of CRTP so 
 // the methods are resolved statically with no overhead of virtual calls.
 
+//
+// Mutually dependent defaults impose a minimal complete definition 
+// (here: foo or bar). An instance defining neither would recurse 
+// forever at runtime, so the defaults check it at compile time with 
+// TC_OVERRIDES.
+
 template<class T>
 struct Foo {
+    static constexpr bool complete() {
+        return TC_OVERRIDES(foo, Foo<T>) || TC_OVERRIDES(bar, Foo<T>);
+    }
+
     static int foo(int x) {
+        static_assert(complete(), "Foo: define foo or bar");
         TC_IMPL(Foo<T>) FooT; 
         return FooT::bar(x) + 1;
     }
 
     static int bar(int x) {
+        static_assert(complete(), "Foo: define foo or bar");
         TC_IMPL(Foo<T>) FooT; 
         return FooT::foo(x) - 1;
     }
 };
 
-struct Bar; struct Baz; struct Quuz;
+struct Bar; struct Baz; struct Quuz; struct Nope;
 
 template<>
 TC_INSTANCE(Foo<Bar>, {
@@ -51,6 +63,10 @@ TC_INSTANCE(Foo<Quuz>, {
     }
 })
 
+// template<>
+// TC_INSTANCE(Foo<Nope>, {}) // compiles, but tc_impl_t<Foo<Nope>>::foo 
+//                            // won't: "Foo: define foo or bar"
+
 
 int main() {
     std::cout << tc_impl_t<Foo<Bar>>::foo(1) << " "
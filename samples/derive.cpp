@@ -0,0 +1,250 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstring>
+#include <cstdint>
+#include <functional>
+#include <assert.h>
+#include "../tc_derive.hpp"
+
+// Instances of Eq, Ord, Show and Hash for structs derived from a list
+// of their fields (TC_FIELDS and TC_DERIVE from tc_derive.hpp) instead
+// of being written field by field.
+
+template<class T>
+struct Eq {
+    static bool equal(T const & a, T const & b) = delete;
+
+    // a bulk method (cf. bulk.cpp)
+    static bool equal_n(T const * a, T const * b, size_t n) {
+        for (size_t i = 0; i < n; i++) {
+            if (!tc_impl_t<Eq<T>>::equal(a[i], b[i])) return false;
+        }
+        return true;
+    }
+};
+
+// compare(a, b) is negative, zero or positive
+template<class T>
+struct Ord {
+    TC_REQUIRE(Eq<T>); // a superclass (cf. super.cpp)
+
+    static int compare(T const & a, T const & b) = delete;
+};
+
+template<class T>
+struct Show {
+    static std::string show(T const & x) = delete;
+};
+
+template<class T>
+struct Hash {
+    TC_REQUIRE(Eq<T>);
+
+    static size_t hash(T const & x) = delete;
+};
+
+// a marker: equality is the equality of the bytes (cf. eq_bitwise.cpp)
+template<class T>
+struct BitwiseEq {};
+
+template<class T>
+using HasInstance = std::integral_constant<bool, tc_has_instance<T>::value>;
+
+template<class T>
+using IsBitwiseEq = HasInstance<BitwiseEq<T>>;
+
+
+inline size_t hash_combine(size_t seed, size_t h) {
+    uint64_t x = seed * 0x9E3779B97F4A7C15ULL + h;
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    return size_t(x);
+}
+
+
+// --------------------- deriving for the typeclasses --------------------- //
+
+template<class T>
+struct tc_derived<Eq<T>>: Eq<T> {
+    static bool equal(T const & a, T const & b) {
+        return !tc_first_field2(a, b, [](auto const & x, auto const & y) {
+            return !tc_impl_t<Eq<std::decay_t<decltype(x)>>>::equal(x, y);
+        });
+    }
+
+    static bool equal_n(T const * a, T const * b, size_t n) {
+        return equal_n_(a, b, n, std::integral_constant<bool,
+            tc_fields_all<T, IsBitwiseEq>::value>());
+    }
+
+private:
+    // all the fields are bitwise and there is no padding: memcmp
+    static bool equal_n_(T const * a, T const * b, size_t n, std::true_type) {
+        return n == 0 || std::memcmp(a, b, n * sizeof(T)) == 0;
+    }
+
+    static bool equal_n_(T const * a, T const * b, size_t n, std::false_type) {
+        return Eq<T>::equal_n(a, b, n);
+    }
+};
+
+// lexicographic
+template<class T>
+struct tc_derived<Ord<T>>: Ord<T> {
+    static int compare(T const & a, T const & b) {
+        return tc_first_field2(a, b, [](auto const & x, auto const & y) {
+            return tc_impl_t<Ord<std::decay_t<decltype(x)>>>::compare(x, y);
+        });
+    }
+};
+
+// {field = value, ...}
+template<class T>
+struct tc_derived<Show<T>>: Show<T> {
+    static std::string show(T const & x) {
+        std::string res = "{";
+        tc_each_field(x, [&](char const * name, auto const & f) {
+            if (res.size() > 1) res += ", ";
+            res += name;
+            res += " = ";
+            res += tc_impl_t<Show<std::decay_t<decltype(f)>>>::show(f);
+        });
+        return res + "}";
+    }
+};
+
+template<class T>
+struct tc_derived<Hash<T>>: Hash<T> {
+    static size_t hash(T const & x) {
+        size_t h = 0;
+        tc_each_field(x, [&](char const *, auto const & f) {
+            h = hash_combine(h, tc_impl_t<Hash<std::decay_t<decltype(f)>>>::hash(f));
+        });
+        return h;
+    }
+};
+
+// a struct is bitwise if all its fields are and it has no padding
+template<class T>
+TC_INSTANCE_IF(BitwiseEq<T>,
+    TC(typename std::enable_if<tc_fields_all<T, IsBitwiseEq>::value>::type), {});
+
+
+// -------------------------- base instances -------------------------- //
+
+template<>
+TC_INSTANCE(Eq<int>, {
+    static bool equal(int const & a, int const & b) { return a == b; }
+});
+
+template<>
+TC_INSTANCE(Ord<int>, {
+    static int compare(int const & a, int const & b) { return (a > b) - (a < b); }
+});
+
+template<>
+TC_INSTANCE(Show<int>, {
+    static std::string show(int const & x) { return std::to_string(x); }
+});
+
+template<>
+TC_INSTANCE(Hash<int>, {
+    static size_t hash(int const & x) { return size_t(unsigned(x)); }
+});
+
+template<> TC_INSTANCE(BitwiseEq<int>, {});
+
+template<>
+TC_INSTANCE(Eq<char>, {
+    static bool equal(char const & a, char const & b) { return a == b; }
+});
+
+template<> TC_INSTANCE(BitwiseEq<char>, {});
+
+template<>
+TC_INSTANCE(Eq<std::string>, {
+    static bool equal(std::string const & a, std::string const & b) {
+        return a == b;
+    }
+});
+
+template<>
+TC_INSTANCE(Ord<std::string>, {
+    static int compare(std::string const & a, std::string const & b) {
+        int c = a.compare(b);
+        return (c > 0) - (c < 0);
+    }
+});
+
+template<>
+TC_INSTANCE(Show<std::string>, {
+    static std::string show(std::string const & x) { return '"' + x + '"'; }
+});
+
+template<>
+TC_INSTANCE(Hash<std::string>, {
+    static size_t hash(std::string const & x) { return std::hash<std::string>()(x); }
+});
+
+template<class T>
+TC_INSTANCE(Eq<std::vector<T>>, {
+    static bool equal(std::vector<T> const & a, std::vector<T> const & b) {
+        return a.size() == b.size()
+            && tc_impl_t<Eq<T>>::equal_n(a.data(), b.data(), a.size());
+    }
+});
+
+
+// ----------------------------- user types ----------------------------- //
+
+struct Point { int x, y; };
+TC_FIELDS(Point, x, y)
+TC_DERIVE(Point, Eq, Ord, Show, Hash)
+
+struct Person { std::string name; int age; Point home; };
+TC_FIELDS(Person, name, age, home)
+TC_DERIVE(Person, Eq, Ord, Show, Hash)
+
+struct Padded { char c; int i; };
+TC_FIELDS(Padded, c, i)
+TC_DERIVE(Padded, Eq)
+
+
+int main() {
+    static_assert(tc_fields<Person>::size == 3, "");
+    static_assert(HasInstance<BitwiseEq<Point>>::value, "");
+    static_assert(!HasInstance<BitwiseEq<Person>>::value, "a string field");
+    static_assert(!HasInstance<BitwiseEq<Padded>>::value, "padding");
+
+    Point p = {1, 2}, q = {1, 3};
+    Person alice = {"Alice", 30, p}, bob = {"Bob", 25, q};
+
+    std::cout << tc_impl_t<Show<Point>>::show(p) << std::endl;
+    std::cout << tc_impl_t<Show<Person>>::show(alice) << std::endl;
+
+    assert(tc_impl_t<Show<Person>>::show(bob)
+           == "{name = \"Bob\", age = 25, home = {x = 1, y = 3}}");
+
+    assert(tc_impl_t<Eq<Point>>::equal(p, p));
+    assert(!tc_impl_t<Eq<Point>>::equal(p, q));
+    assert(tc_impl_t<Ord<Point>>::compare(p, q) < 0);
+    assert(tc_impl_t<Ord<Person>>::compare(bob, alice) > 0);
+    assert(tc_impl_t<Ord<Person>>::compare(alice, alice) == 0);
+
+    assert(tc_impl_t<Hash<Person>>::hash(alice) == tc_impl_t<Hash<Person>>::hash(Person(alice)));
+    assert(tc_impl_t<Hash<Point>>::hash(p) != tc_impl_t<Hash<Point>>::hash(q));
+
+    // vectors of points are compared with memcmp, of persons field by field
+    std::vector<Point> ps(1000, p), qs = ps;
+    std::vector<Person> xs(10, alice), ys = xs;
+    assert(tc_impl_t<Eq<std::vector<Point>>>::equal(ps, qs));
+    assert(tc_impl_t<Eq<std::vector<Person>>>::equal(xs, ys));
+    qs.back().y++;
+    ys.back().home.y++;
+    assert(!tc_impl_t<Eq<std::vector<Point>>>::equal(ps, qs));
+    assert(!tc_impl_t<Eq<std::vector<Person>>>::equal(xs, ys));
+
+    assert(!tc_impl_t<Eq<Padded>>::equal(Padded{'a', 1}, Padded{'a', 2}));
+}
@@ -0,0 +1,142 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <memory>
+#include <cstdlib>
+#include <new>
+#include <type_traits>
+#include <assert.h>
+#include "../tc_dyn.hpp"
+#include "allocs.hpp" // allocations are counted to show the boxing
+
+// Borrowing instead of boxing (tc_dyn.hpp): a non-template function
+// taking "any Show" as a tc_dyn_ref<Show>, which is a pointer to the
+// value and a pointer to the table of its type. Unlike to_show of
+// show.cpp (a unique_ptr<DynShow>), it doesn't allocate nor copy the
+// value, and it is passed by value in two registers.
+
+
+template<class T>
+struct Show {
+    static std::string show(T const &) = delete;
+};
+
+template<>
+TC_INSTANCE(Show<int>, {
+    static std::string show(int const & x) {
+        return "int" + std::to_string(x);
+    }
+});
+
+struct Foo { int x; };
+
+template<>
+TC_INSTANCE(Show<Foo>, {
+    static std::string show(Foo const &) {
+        return "Foo";
+    }
+});
+
+struct NoShow {};
+
+template<class T>
+TC_INSTANCE(Show<std::vector<T>>, {
+    static std::string show(std::vector<T> const & xs) {
+        std::string res = "[";
+        for (std::size_t i = 0; i < xs.size(); i++) {
+            if (i) res += ",";
+            res += tc_impl_t<Show<T>>::show(xs[i]);
+        }
+        return res + "]";
+    }
+});
+
+#define SHOW_METHODS(m) \
+    m(show, std::string())
+
+TC_DYN(Show, SHOW_METHODS)
+
+
+// the boxing of show.cpp, for comparison
+struct DynShow {
+    virtual std::string show_me() const = 0;
+    virtual ~DynShow() {}
+};
+
+template<class T>
+struct DynShowWrapper: DynShow {
+    T self;
+    std::string show_me() const { return tc_impl_t<Show<T>>::show(self); }
+    DynShowWrapper(T x): self(x) {}
+};
+
+template<class T>
+std::unique_ptr<DynShow> to_show(T x) {
+    return std::make_unique<DynShowWrapper<T>>(x);
+}
+
+
+// Separately compilable: one definition for all the types.
+std::size_t shown_size_boxed(std::unique_ptr<DynShow> const & x) {
+    return x->show_me().size();
+}
+
+std::size_t shown_size(tc_dyn_ref<Show> x) {
+    return tc_impl_t<Show<tc_dyn_ref<Show>>>::show(x).size();
+}
+
+std::string show_both(tc_dyn_ref<Show> a, tc_dyn_ref<Show> b) {
+    return tc_impl_t<Show<tc_dyn_ref<Show>>>::show(a) + " & " +
+           tc_impl_t<Show<tc_dyn_ref<Show>>>::show(b);
+}
+
+
+// two pointers, copied as such
+static_assert(std::is_trivially_copyable<tc_dyn_ref<Show>>::value, "");
+static_assert(sizeof(tc_dyn_ref<Show>) == 2 * sizeof(void *), "");
+
+// only lvalues with an instance
+static_assert(std::is_convertible<int &, tc_dyn_ref<Show>>::value, "");
+static_assert(std::is_convertible<Foo const &, tc_dyn_ref<Show>>::value, "");
+static_assert(!std::is_convertible<int, tc_dyn_ref<Show>>::value, "a temporary");
+static_assert(!std::is_convertible<NoShow &, tc_dyn_ref<Show>>::value, "no instance");
+
+
+int main() {
+    int i = 3;
+    Foo foo{ 1 };
+    std::vector<int> xs = { 1, 2 };
+
+    // boxing: one allocation and one copy per call
+    std::size_t before = allocs;
+    std::size_t boxed = shown_size_boxed(to_show(i)) + shown_size_boxed(to_show(foo));
+    assert(allocs - before == 2);
+
+    // borrowing: none (the results fit in the small string buffer)
+    before = allocs;
+    std::size_t borrowed = shown_size(i) + shown_size(foo);
+    assert(allocs == before);
+    assert(borrowed == boxed);
+
+    // a reference is a value: copied, stored, shown
+    tc_dyn_ref<Show> r = xs;
+    tc_dyn_ref<Show> copy = r;
+    assert(copy.get() == &xs);
+    xs.push_back(3); // seen through the reference
+    assert(tc_impl_t<Show<tc_dyn_ref<Show>>>::show(copy) == "[int1,int2,int3]");
+
+    // a vector of references is shown through Show<std::vector<T>>
+    std::vector<tc_dyn_ref<Show>> refs = { i, foo, xs };
+    std::cout << tc_impl_t<Show<std::vector<tc_dyn_ref<Show>>>>::show(refs) << std::endl;
+
+    // borrowing from an owning existential shares its table
+    tc_dyn<Show> owned = to_dyn<Show>(foo);
+    tc_dyn_ref<Show> from_owned = owned;
+    assert(from_owned.get() == owned.get() && from_owned.vtable() == owned.vtable());
+
+    // speculative calls work on references too
+    typedef tc_speculate_t<Show, int> S;
+    assert(S::show(tc_dyn_ref<Show>(i)) == "int3");
+
+    std::cout << show_both(i, foo) << std::endl;
+}
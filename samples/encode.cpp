@@ -0,0 +1,129 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <memory>
+#include <tuple>
+#include <utility>
+#include <cstdio>
+#include <cstdint>
+#include <cassert>
+#include <unistd.h>
+#include "encode.hpp"
+
+// The binary Encode/Decode typeclasses of encode.hpp: records written
+// to a file and read back, streaming, malformed and truncated inputs.
+
+
+// a user type opting into the memcpy path
+struct Point { int32_t x, y; };
+
+template<> TC_INSTANCE(FixedSize<Point>, {});
+
+
+int main() {
+    static_assert(HasInstance<FixedSize<Point>>::value, "");
+    static_assert(!HasInstance<FixedSize<std::pair<int, int>>>::value, "");
+    static_assert(HasInstance<Encode<std::vector<std::pair<int, std::string>>>>::value, "");
+    static_assert(!HasInstance<Encode<Point *>>::value, "");
+    static_assert(!HasInstance<FixedSize<bool>>::value, "");
+
+    typedef std::tuple<int, std::string, std::vector<Point>> Record;
+
+    std::FILE * file = std::tmpfile();
+    int fd = fileno(file);
+    int const count = 10000;
+
+    {
+        Writer w(fd);
+        for (int i = 0; i < count; i++) {
+            std::vector<Point> ps(i % 100, Point{i, -i});
+            encode(w, Record(i, std::to_string(i), ps));
+        }
+
+        std::vector<std::pair<double, std::unique_ptr<int>>> xs;
+        xs.emplace_back(0.5, nullptr);
+        xs.emplace_back(1.5, std::unique_ptr<int>(new int(42)));
+        encode(w, xs);
+
+        bool flushed = w.flush();
+        assert(flushed);
+    }
+
+    ::lseek(fd, 0, SEEK_SET);
+
+    {
+        Reader r(fd, 4096);
+        long sum = 0;
+        int seen = 0;
+        for (int i = 0; i < count; i++) {
+            Record rec;
+            bool ok = decode(r, rec);
+            assert(ok);
+            assert(std::get<0>(rec) == i && std::get<1>(rec) == std::to_string(i));
+            assert(std::get<2>(rec).size() == size_t(i % 100));
+            for (Point p: std::get<2>(rec)) sum += p.x + p.y;
+            seen++;
+        }
+        assert(sum == 0 && seen == count);
+
+        std::vector<std::pair<double, std::unique_ptr<int>>> xs;
+        bool ok = decode(r, xs);
+        assert(ok && xs.size() == 2 && !xs[0].second && *xs[1].second == 42);
+        assert(r.at_end());
+
+        std::cout << seen << " records" << std::endl;
+    }
+
+    // bools: only the bytes 0 and 1 are accepted
+    ::lseek(fd, 0, SEEK_SET);
+    bool cleared = ::ftruncate(fd, 0) == 0;
+    assert(cleared);
+    {
+        Writer w(fd);
+        encode(w, std::vector<bool>{true, false, true});
+        uint8_t bad[] = { 1, 0, 0, 0, 0, 0, 0, 0, 2 }; // a size of 1 and the byte 2
+        w.write(bad, sizeof(bad));
+    }
+    ::lseek(fd, 0, SEEK_SET);
+    {
+        Reader r(fd);
+        std::vector<bool> bs;
+        bool ok = decode(r, bs);
+        assert(ok && bs == std::vector<bool>({true, false, true}));
+        ok = decode(r, bs);
+        assert(!ok);
+    }
+
+    // streaming: a sequence of records until the end of input
+    ::lseek(fd, 0, SEEK_SET);
+    bool emptied = ::ftruncate(fd, 0) == 0;
+    assert(emptied);
+    {
+        Writer w(fd);
+        for (int i = 0; i < count; i++) encode(w, std::make_pair(i, double(i) / 2));
+    }
+    ::lseek(fd, 0, SEEK_SET);
+    {
+        Reader r(fd);
+        int n = 0;
+        bool ok = decode_each<std::pair<int, double>>(r, [&](std::pair<int, double> const & x) {
+            assert(x.first == n && x.second == double(n) / 2);
+            n++;
+        });
+        assert(ok && n == count);
+    }
+
+    // a truncated input is detected (a record takes 4 + 8 bytes)
+    bool truncated = ::ftruncate(fd, 12 * 100 + 5) == 0;
+    ::lseek(fd, 0, SEEK_SET);
+    {
+        Reader r(fd);
+        int n = 0;
+        bool ok = decode_each<std::pair<int, double>>(r, [&](std::pair<int, double> const &) {
+            n++;
+        });
+        assert(truncated && !ok && n == 100);
+    }
+
+    std::fclose(file);
+}
@@ -0,0 +1,386 @@
+// Binary serialization typeclasses composed like Eq/Show instances,
+// shared by encode.cpp and bench/encode.cpp.
+//
+// Encoding writes into a buffered Writer which flushes to a file
+// descriptor in large chunks; decoding reads from a Reader which refills
+// its buffer from a file descriptor on demand, so the input is never
+// materialized as a whole.
+//
+// The format uses the native sizes and byte order (i.e. it is meant for
+// the same machine: caches, IPC etc.). Sizes are written as uint64_t.
+
+#ifndef _ENCODE_HPP_
+#define _ENCODE_HPP_
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <tuple>
+#include <utility>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <cerrno>
+#include <type_traits>
+#include <unistd.h>
+#include "../tc.hpp"
+
+
+// ---------------------------- streams ---------------------------- //
+
+class Writer {
+    int fd;
+    std::vector<char> buf;
+    size_t len = 0;
+    bool failed = false;
+
+    void write_fd(char const * p, size_t n) {
+        while (n > 0 && !failed) {
+            ssize_t k = ::write(fd, p, n);
+            if (k < 0 && errno == EINTR) continue;
+            if (k < 0) { failed = true; break; }
+            p += k; n -= size_t(k);
+        }
+    }
+
+public:
+    explicit Writer(int fd, size_t capacity = 1 << 16): fd(fd), buf(capacity) {}
+    Writer(Writer const &) = delete;
+    ~Writer() { flush(); }
+
+    void write(void const * data, size_t n) {
+        if (n == 0) return; // data may be null (an empty vector)
+        char const * p = static_cast<char const *>(data);
+        if (len + n > buf.size()) {
+            flush();
+            // large blocks bypass the buffer
+            if (n >= buf.size()) { write_fd(p, n); return; }
+        }
+        std::memcpy(buf.data() + len, p, n);
+        len += n;
+    }
+
+    // false if some write has failed
+    bool flush() {
+        write_fd(buf.data(), len);
+        len = 0;
+        return !failed;
+    }
+};
+
+class Reader {
+    int fd;
+    std::vector<char> buf;
+    size_t pos = 0, len = 0;
+
+    bool refill() {
+        pos = 0;
+        ssize_t k;
+        do k = ::read(fd, buf.data(), buf.size()); while (k < 0 && errno == EINTR);
+        len = k > 0 ? size_t(k) : 0;
+        return len > 0;
+    }
+
+public:
+    explicit Reader(int fd, size_t capacity = 1 << 16): fd(fd), buf(capacity) {}
+    Reader(Reader const &) = delete;
+
+    // false on a premature end of input
+    bool read(void * data, size_t n) {
+        char * p = static_cast<char *>(data);
+        while (n > 0) {
+            if (pos == len) {
+                // large blocks bypass the buffer
+                if (n >= buf.size()) {
+                    ssize_t k = ::read(fd, p, n);
+                    if (k < 0 && errno == EINTR) continue;
+                    if (k <= 0) return false;
+                    p += k; n -= size_t(k);
+                    continue;
+                }
+                if (!refill()) return false;
+            }
+            size_t k = std::min(n, len - pos);
+            std::memcpy(p, buf.data() + pos, k);
+            pos += k; p += k; n -= k;
+        }
+        return true;
+    }
+
+    bool at_end() {
+        return pos == len && !refill();
+    }
+};
+
+
+// -------------------------- typeclasses -------------------------- //
+
+template<class T>
+struct Encode {
+    static void encode(Writer &, T const &) = delete;
+};
+
+// false on a malformed or truncated input
+template<class T>
+struct Decode {
+    static bool decode(Reader &, T &) = delete;
+};
+
+// A marker: the encoding of T is its object representation, so
+// T can be copied with memcpy (T must be trivially copyable).
+//
+// Note: std::pair and std::tuple are not trivially copyable (and the
+// elements of a libstdc++ tuple are stored in the reverse order), so
+// they are encoded element by element.
+template<class T>
+struct FixedSize {};
+
+template<class T>
+using HasInstance = std::integral_constant<bool, tc_has_instance<T>::value>;
+
+
+// FixedSize a => Encode a, Decode a
+template<class T>
+TC_INSTANCE_IF(Encode<T>, tc_require_t<FixedSize<T>>, {
+    static void encode(Writer & w, T const & x) {
+        w.write(&x, sizeof(T));
+    }
+});
+
+template<class T>
+TC_INSTANCE_IF(Decode<T>, tc_require_t<FixedSize<T>>, {
+    static bool decode(Reader & r, T & x) {
+        return r.read(&x, sizeof(T));
+    }
+});
+
+// arithmetic types, except bool: not every byte is a valid bool
+template<class T>
+TC_INSTANCE_IF(FixedSize<T>,
+    typename std::enable_if<(std::is_arithmetic<T>::value && 
+                             !std::is_same<T, bool>::value)>::type, {});
+
+
+// bool: a byte, 0 or 1
+
+template<>
+TC_INSTANCE(Encode<bool>, {
+    static void encode(Writer & w, bool const & x) {
+        uint8_t b = x ? 1 : 0;
+        w.write(&b, 1);
+    }
+});
+
+template<>
+TC_INSTANCE(Decode<bool>, {
+    static bool decode(Reader & r, bool & x) {
+        uint8_t b;
+        if (!r.read(&b, 1) || b > 1) return false;
+        x = b == 1;
+        return true;
+    }
+});
+
+
+// strings
+
+template<>
+TC_INSTANCE(Encode<std::string>, {
+    static void encode(Writer & w, std::string const & s) {
+        uint64_t n = s.size();
+        w.write(&n, sizeof(n));
+        w.write(s.data(), s.size());
+    }
+});
+
+template<>
+TC_INSTANCE(Decode<std::string>, {
+    static bool decode(Reader & r, std::string & s) {
+        uint64_t n;
+        if (!r.read(&n, sizeof(n))) return false;
+
+        // grow step by step: a corrupted size must not allocate everything
+        s.clear();
+        while (s.size() < n) {
+            size_t done = s.size();
+            size_t k = size_t(std::min<uint64_t>(n - done, 1 << 16));
+            s.resize(done + k);
+            if (!r.read(&s[done], k)) return false;
+        }
+        return true;
+    }
+});
+
+
+// (Encode a, Encode b) => Encode (a, b) and the same for Decode
+
+template<class A, class B>
+TC_INSTANCE(TC(Encode<std::pair<A, B>>), {
+    static void encode(Writer & w, std::pair<A, B> const & x) {
+        tc_impl_t<Encode<A>>::encode(w, x.first);
+        tc_impl_t<Encode<B>>::encode(w, x.second);
+    }
+});
+
+template<class A, class B>
+TC_INSTANCE(TC(Decode<std::pair<A, B>>), {
+    static bool decode(Reader & r, std::pair<A, B> & x) {
+        return tc_impl_t<Decode<A>>::decode(r, x.first)
+            && tc_impl_t<Decode<B>>::decode(r, x.second);
+    }
+});
+
+
+// tuples: the elements in order
+
+template<class... Ts>
+TC_INSTANCE(Encode<std::tuple<Ts...>>, {
+    static void encode(Writer & w, std::tuple<Ts...> const & x) {
+        encode_(w, x, std::index_sequence_for<Ts...>());
+    }
+
+    template<size_t... I>
+    static void encode_(Writer & w, std::tuple<Ts...> const & x,
+                        std::index_sequence<I...>) {
+        int dummy[] = { 0, (tc_impl_t<Encode<Ts>>::encode(w, std::get<I>(x)), 0)... };
+        (void)dummy;
+    }
+});
+
+template<class... Ts>
+TC_INSTANCE(Decode<std::tuple<Ts...>>, {
+    static bool decode(Reader & r, std::tuple<Ts...> & x) {
+        return decode_(r, x, std::index_sequence_for<Ts...>());
+    }
+
+    template<size_t... I>
+    static bool decode_(Reader & r, std::tuple<Ts...> & x,
+                        std::index_sequence<I...>) {
+        bool ok = true;
+        int dummy[] = { 0, (ok = ok && tc_impl_t<Decode<Ts>>::decode(r, std::get<I>(x)), 0)... };
+        (void)dummy;
+        return ok;
+    }
+});
+
+
+// unique pointers: a presence flag and the value
+
+template<class T>
+TC_INSTANCE(Encode<std::unique_ptr<T>>, {
+    static void encode(Writer & w, std::unique_ptr<T> const & p) {
+        uint8_t present = p ? 1 : 0;
+        w.write(&present, 1);
+        if (p) tc_impl_t<Encode<T>>::encode(w, *p);
+    }
+});
+
+template<class T>
+TC_INSTANCE(Decode<std::unique_ptr<T>>, {
+    static bool decode(Reader & r, std::unique_ptr<T> & p) {
+        uint8_t present;
+        if (!r.read(&present, 1) || present > 1) return false;
+
+        p.reset(present ? new T() : nullptr);
+        return !present || tc_impl_t<Decode<T>>::decode(r, *p);
+    }
+});
+
+
+// vectors: the size and the elements, with a single memcpy
+// for FixedSize elements (selected at compile time)
+//
+// std::vector<bool> has no data() and its elements are proxies:
+// it takes the element by element path (bool is not FixedSize).
+
+template<class T>
+void encode_n(Writer & w, std::vector<T> const & xs, std::true_type /* fixed */) {
+    w.write(xs.data(), xs.size() * sizeof(T));
+}
+
+template<class T>
+void encode_n(Writer & w, std::vector<T> const & xs, std::false_type /* fixed */) {
+    for (size_t i = 0; i < xs.size(); i++) tc_impl_t<Encode<T>>::encode(w, xs[i]);
+}
+
+template<class T>
+bool decode_element(Reader & r, std::vector<T> & xs, size_t i) {
+    return tc_impl_t<Decode<T>>::decode(r, xs[i]);
+}
+
+inline bool decode_element(Reader & r, std::vector<bool> & xs, size_t i) {
+    bool x;
+    if (!tc_impl_t<Decode<bool>>::decode(r, x)) return false;
+    xs[i] = x;
+    return true;
+}
+
+// decodes the elements [from, from + n) of xs
+template<class T>
+bool decode_n(Reader & r, std::vector<T> & xs, size_t from, size_t n, std::true_type /* fixed */) {
+    return r.read(&xs[from], n * sizeof(T));
+}
+
+template<class T>
+bool decode_n(Reader & r, std::vector<T> & xs, size_t from, size_t n, std::false_type /* fixed */) {
+    for (size_t i = from; i < from + n; i++) {
+        if (!decode_element(r, xs, i)) return false;
+    }
+    return true;
+}
+
+template<class T>
+TC_INSTANCE(Encode<std::vector<T>>, {
+    static void encode(Writer & w, std::vector<T> const & xs) {
+        uint64_t n = xs.size();
+        w.write(&n, sizeof(n));
+        encode_n(w, xs, HasInstance<FixedSize<T>>());
+    }
+});
+
+template<class T>
+TC_INSTANCE(Decode<std::vector<T>>, {
+    static bool decode(Reader & r, std::vector<T> & xs) {
+        uint64_t n;
+        if (!r.read(&n, sizeof(n))) return false;
+
+        // grow step by step: a corrupted size must not allocate everything
+        xs.clear();
+        while (xs.size() < n) {
+            size_t done = xs.size();
+            size_t k = size_t(std::min<uint64_t>(n - done, 1 << 12));
+            xs.resize(done + k);
+            if (!decode_n(r, xs, done, k, HasInstance<FixedSize<T>>())) {
+                return false;
+            }
+        }
+        return true;
+    }
+});
+
+
+// ------------------------------------------------------------------ //
+
+template<class T>
+void encode(Writer & w, T const & x) {
+    tc_impl_t<Encode<T>>::encode(w, x);
+}
+
+template<class T>
+bool decode(Reader & r, T & x) {
+    return tc_impl_t<Decode<T>>::decode(r, x);
+}
+
+// decodes the records one by one until the end of input,
+// false if the input ends inside a record or is malformed
+template<class T, class F>
+bool decode_each(Reader & r, F f) {
+    T x;
+    while (!r.at_end()) {
+        if (!decode(r, x)) return false;
+        f(x);
+    }
+    return true;
+}
+
+#endif // _ENCODE_HPP_
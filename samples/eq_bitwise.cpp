@@ -0,0 +1,36 @@
+#include <iostream>
+#include <utility>
+#include <vector>
+#include <array>
+#include <assert.h>
+#include "eq_bitwise.hpp"
+
+// Fast paths for Eq and Ord instances of contiguous containers
+// (eq_bitwise.hpp): a memcmp/SIMD kernel for BitwiseEq element types.
+
+struct Padded { char c; int i; };
+
+int main() {
+    static_assert(HasInstance<BitwiseEq<std::pair<int, int>>>::value, "");
+    static_assert(HasInstance<BitwiseEq<std::array<std::pair<int, int>, 3>>>::value, "");
+    static_assert(!HasInstance<BitwiseEq<double>>::value, "-0.0 == 0.0, NaN != NaN");
+    static_assert(!HasInstance<BitwiseEq<std::pair<Padded, int>>>::value, "");
+
+    TC_IMPL(Eq<std::vector<std::pair<int, int>>>) EV;
+    TC_IMPL(Ord<std::vector<int>>) OV;
+
+    std::vector<std::pair<int, int>> xs(1000, {1, 2}), ys = xs;
+    assert(EV::equal(xs, ys));
+    ys[999].second = 3;
+    assert(!EV::equal(xs, ys));
+
+    std::vector<int> a(100, 7), b = a;
+    assert(OV::compare(a, b) == 0);
+    b[50] = -1;                       // the first byte differs at 50*4, 
+    assert(OV::compare(a, b) > 0);    // then compared as ints: 7 > -1
+    b.pop_back();
+    a.resize(50);
+    assert(OV::compare(a, b) < 0);    // a prefix
+
+    std::cout << "ok" << std::endl;
+}
@@ -0,0 +1,194 @@
+// Fast paths for Eq and Ord instances of contiguous containers,
+// shared by eq_bitwise.cpp and bench/eq_vector.cpp.
+//
+// A marker typeclass BitwiseEq<T> states that two values of T are equal
+// iff their object representations are equal. It is implemented 
+// for int and derived for pairs and arrays of such types without padding.
+// The instances for std::vector select a memcmp/SIMD kernel 
+// at compile time if the element type is BitwiseEq.
+
+#ifndef _EQ_BITWISE_HPP_
+#define _EQ_BITWISE_HPP_
+
+#include <utility>
+#include <vector>
+#include <array>
+#include <cstring>
+#include <type_traits>
+#include "../tc.hpp"
+
+#if defined(__SSE2__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+template<class T>
+struct Eq {
+    static bool equal(T const & a, T const & b) = delete;
+};
+
+// compare(a, b) is negative, zero or positive
+template<class T>
+struct Ord {
+    TC_REQUIRE(Eq<T>); // Eq is a superclass of Ord (cf. super.cpp)
+
+    static int compare(T const & a, T const & b) = delete;
+};
+
+template<class T>
+struct BitwiseEq {};
+
+
+// The marker instances for pairs and arrays are constrained instances
+// (TC_INSTANCE_IF), so tc_has_instance<BitwiseEq<T>> is a compile-time test.
+template<class T>
+using HasInstance = std::integral_constant<bool, tc_has_instance<T>::value>;
+
+
+// int
+
+template<> 
+TC_INSTANCE(Eq<int>, {
+    static bool equal(int const & a, int const & b) {
+        return a == b;
+    }
+});
+
+template<> 
+TC_INSTANCE(Ord<int>, {
+    static int compare(int const & a, int const & b) {
+        return (a > b) - (a < b);
+    }
+});
+
+template<> TC_INSTANCE(BitwiseEq<int>, {});
+
+
+// pairs
+
+template<class A, class B> 
+TC_INSTANCE(TC(Eq<std::pair<A, B>>), {
+    TC_IMPL(Eq<A>) EA; 
+    TC_IMPL(Eq<B>) EB;
+
+    static bool equal(std::pair<A,B> const & pa, std::pair<A,B> const & pb) {
+        return
+            EA::equal(pa.first, pb.first) and
+            EB::equal(pa.second, pb.second);
+    }
+});
+
+template<class A, class B> 
+TC_INSTANCE(TC(Ord<std::pair<A, B>>), {
+    static int compare(std::pair<A,B> const & pa, std::pair<A,B> const & pb) {
+        int c = tc_impl_t<Ord<A>>::compare(pa.first, pb.first);
+        return c != 0 ? c : tc_impl_t<Ord<B>>::compare(pa.second, pb.second);
+    }
+});
+
+// BitwiseEq a, BitwiseEq b, no padding => BitwiseEq (a, b)
+template<class A, class B> 
+TC_INSTANCE_IF(TC(BitwiseEq<std::pair<A, B>>), TC(typename std::enable_if<
+    HasInstance<BitwiseEq<A>>::value && HasInstance<BitwiseEq<B>>::value &&
+    sizeof(std::pair<A, B>) == sizeof(A) + sizeof(B)
+>::type), {});
+
+
+// arrays
+
+template<class T, std::size_t N> 
+TC_INSTANCE(TC(Eq<std::array<T, N>>), {
+    static bool equal(std::array<T, N> const & a, std::array<T, N> const & b) {
+        for (std::size_t i = 0; i < N; i++) {
+            if (!tc_impl_t<Eq<T>>::equal(a[i], b[i])) return false;
+        }
+        return true;
+    }
+});
+
+// BitwiseEq a, no padding => BitwiseEq (array a n)
+template<class T, std::size_t N> 
+TC_INSTANCE_IF(TC(BitwiseEq<std::array<T, N>>), TC(typename std::enable_if<
+    HasInstance<BitwiseEq<T>>::value && sizeof(std::array<T, N>) == N * sizeof(T)
+>::type), {});
+
+
+// Kernels.
+
+// the offset of the first differing byte (n if there is none)
+inline std::size_t first_mismatch(void const * pa, void const * pb, std::size_t n) {
+    unsigned char const * a = static_cast<unsigned char const *>(pa);
+    unsigned char const * b = static_cast<unsigned char const *>(pb);
+    std::size_t i = 0;
+
+#if defined(__AVX2__)
+    for (; i + 32 <= n; i += 32) {
+        __m256i x = _mm256_loadu_si256((__m256i const *)(a + i));
+        __m256i y = _mm256_loadu_si256((__m256i const *)(b + i));
+        unsigned mask = ~unsigned(_mm256_movemask_epi8(_mm256_cmpeq_epi8(x, y)));
+        if (mask) return i + __builtin_ctz(mask);
+    }
+#endif
+#if defined(__SSE2__)
+    for (; i + 16 <= n; i += 16) {
+        __m128i x = _mm_loadu_si128((__m128i const *)(a + i));
+        __m128i y = _mm_loadu_si128((__m128i const *)(b + i));
+        unsigned mask = ~unsigned(_mm_movemask_epi8(_mm_cmpeq_epi8(x, y))) & 0xFFFF;
+        if (mask) return i + __builtin_ctz(mask);
+    }
+#endif
+    for (; i < n; i++) {
+        if (a[i] != b[i]) return i;
+    }
+    return n;
+}
+
+template<class T>
+bool equal_n(T const * a, T const * b, std::size_t n, std::true_type /* bitwise */) {
+    return n == 0 || std::memcmp(a, b, n * sizeof(T)) == 0;
+}
+
+template<class T>
+bool equal_n(T const * a, T const * b, std::size_t n, std::false_type /* bitwise */) {
+    for (std::size_t i = 0; i < n; i++) {
+        if (!tc_impl_t<Eq<T>>::equal(a[i], b[i])) return false;
+    }
+    return true;
+}
+
+// the index of the first element which is not equal (n if there is none)
+template<class T>
+std::size_t mismatch_n(T const * a, T const * b, std::size_t n, std::true_type /* bitwise */) {
+    return first_mismatch(a, b, n * sizeof(T)) / sizeof(T);
+}
+
+template<class T>
+std::size_t mismatch_n(T const * a, T const * b, std::size_t n, std::false_type /* bitwise */) {
+    std::size_t i = 0;
+    while (i < n && tc_impl_t<Eq<T>>::equal(a[i], b[i])) i++;
+    return i;
+}
+
+
+// vectors
+
+template<class T>
+TC_INSTANCE(Eq<std::vector<T>>, {
+    static bool equal(std::vector<T> const & a, std::vector<T> const & b) {
+        return a.size() == b.size() && 
+            equal_n(a.data(), b.data(), a.size(), HasInstance<BitwiseEq<T>>());
+    }
+});
+
+template<class T>
+TC_INSTANCE(Ord<std::vector<T>>, {
+    // lexicographic: only the first differing element is compared with Ord
+    static int compare(std::vector<T> const & a, std::vector<T> const & b) {
+        std::size_t n = std::min(a.size(), b.size());
+        std::size_t i = mismatch_n(a.data(), b.data(), n, HasInstance<BitwiseEq<T>>());
+
+        if (i < n) return tc_impl_t<Ord<T>>::compare(a[i], b[i]);
+        return (a.size() > b.size()) - (a.size() < b.size());
+    }
+});
+
+#endif // _EQ_BITWISE_HPP_
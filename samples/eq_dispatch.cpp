@@ -0,0 +1,159 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <array>
+#include <tuple>
+#include <utility>
+#include <cstdint>
+#include <type_traits>
+#include <assert.h>
+#include "../tc.hpp"
+#include "eq_dispatch.hpp"
+
+// Binary methods on existentials: Eq::equal(a, b) where both a and b
+// are erased values.
+//
+// With the DynShow pattern of show.cpp this needs two virtual calls
+// (or a virtual call and a dynamic_cast). Here the set of types is
+// closed (cf. poly_collection.cpp), so every type has a compact id
+// (its position in the set) and a 2-D table of the entries for all the
+// pairs of types is filled at compile time from the instances:
+// a call is a load from the table and a single indirect call
+// (eq_dispatch.hpp).
+
+template<class T>
+struct Eq {
+    static bool equal(T const & a, T const & b) = delete;
+};
+
+// equality of values of two different types (a two-parameter typeclass)
+template<class A, class B>
+struct EqWith {
+    static bool equal(A const & a, B const & b) = delete;
+};
+
+template<class T>
+using HasInstance = std::integral_constant<bool, tc_has_instance<T>::value>;
+
+
+template<>
+TC_INSTANCE(Eq<int>, {
+    static bool equal(int const & a, int const & b) { return a == b; }
+});
+
+template<>
+TC_INSTANCE(Eq<double>, {
+    static bool equal(double const & a, double const & b) { return a == b; }
+});
+
+template<>
+TC_INSTANCE(Eq<std::string>, {
+    static bool equal(std::string const & a, std::string const & b) { return a == b; }
+});
+
+struct Foo { int x; };
+
+template<>
+TC_INSTANCE(Eq<Foo>, {
+    static bool equal(Foo const & a, Foo const & b) { return a.x == b.x; }
+});
+
+// an int and a double are compared numerically
+template<>
+TC_INSTANCE(TC(EqWith<int, double>), {
+    static bool equal(int const & a, double const & b) { return double(a) == b; }
+});
+
+
+// ------------------------ the entries of Eq::equal ------------------------ //
+
+// the same type: Eq
+struct SameType {
+    template<class A>
+    static bool call(A const & a, A const & b) { return tc_impl_t<Eq<A>>::equal(a, b); }
+};
+
+// an instance of EqWith, in either order
+struct Mixed {
+    template<class A, class B>
+    static bool call(A const & a, B const & b) { return tc_impl_t<EqWith<A, B>>::equal(a, b); }
+};
+
+struct MixedSwapped {
+    template<class A, class B>
+    static bool call(A const & a, B const & b) { return tc_impl_t<EqWith<B, A>>::equal(b, a); }
+};
+
+// the fallback: values of unrelated types are different
+struct Unrelated {
+    template<class A, class B>
+    static bool call(A const &, B const &) { return false; }
+};
+
+template<class A, class B>
+struct EqualEntry: std::conditional<std::is_same<A, B>::value, SameType,
+                   typename std::conditional<HasInstance<EqWith<A, B>>::value, Mixed,
+                   typename std::conditional<HasInstance<EqWith<B, A>>::value, MixedSwapped,
+                   Unrelated>::type>::type>::type {};
+
+
+// Eq of the existentials (and so of vectors of them, etc.)
+template<class... Ts>
+TC_INSTANCE(Eq<Dyn<Ts...>>, {
+    static bool equal(Dyn<Ts...> const & a, Dyn<Ts...> const & b) {
+        return dispatch2<EqualEntry>(a, b);
+    }
+});
+
+template<class T>
+TC_INSTANCE(Eq<std::vector<T>>, {
+    static bool equal(std::vector<T> const & a, std::vector<T> const & b) {
+        if (a.size() != b.size()) return false;
+        for (std::size_t i = 0; i < a.size(); i++) {
+            if (!tc_impl_t<Eq<T>>::equal(a[i], b[i])) return false;
+        }
+        return true;
+    }
+});
+
+
+int main() {
+    typedef Dyn<int, double, std::string, Foo> Value;
+    TC_IMPL(Eq<Value>) E;
+
+    // the table is a constant
+    typedef DispatchTable2<EqualEntry, int, double, std::string, Foo> Table;
+    constexpr auto table = Table::table;
+    static_assert(table[0][1] == &Table::entry<int, double>, "");
+    static_assert(table.size() == 4 && table[3].size() == 4, "");
+
+    // move-only: a Dyn lvalue is not taken for a value to wrap
+    static_assert(!std::is_constructible<Value, Value &>::value, "");
+    static_assert(std::is_constructible<Value, Value &&>::value, "");
+
+    Value one(1), one_d(1.0), half(0.5), s(std::string("1")), foo(Foo{1});
+
+    assert(E::equal(one, Value(1)));
+    assert(!E::equal(one, Value(2)));
+    assert(E::equal(foo, Value(Foo{1})));
+    assert(E::equal(s, Value(std::string("1"))));
+
+    // mixed types
+    assert(E::equal(one, one_d));        // EqWith<int, double>
+    assert(E::equal(one_d, one));        // the same, swapped
+    assert(!E::equal(one, half));
+    assert(!E::equal(one, s));           // unrelated
+    assert(!E::equal(foo, one));
+
+    std::vector<Value> xs, ys;
+    xs.emplace_back(1);   ys.emplace_back(1.0);
+    xs.emplace_back(Foo{2}); ys.emplace_back(Foo{2});
+    xs.emplace_back(std::string("x")); ys.emplace_back(std::string("x"));
+
+    std::cout << std::boolalpha << tc_impl_t<Eq<std::vector<Value>>>::equal(xs, ys) << std::endl;
+
+    ys.emplace_back(0.5);
+    std::cout << tc_impl_t<Eq<std::vector<Value>>>::equal(xs, ys) << std::endl;
+
+    // Value x(1u); // won't compile: unsigned is not in the set
+}
@@ -0,0 +1,111 @@
+// Existentials over a closed set of types and the compile-time 2-D
+// tables of binary methods on them, shared by eq_dispatch.cpp and
+// bench/dispatch2.cpp.
+//
+// Every type has a compact id (its position in the set) and the table
+// of a binary method holds the entries for all the pairs of types:
+// a call is a load from the table and a single indirect call.
+
+#ifndef _EQ_DISPATCH_HPP_
+#define _EQ_DISPATCH_HPP_
+
+#include <array>
+#include <tuple>
+#include <utility>
+#include <cstdint>
+#include <type_traits>
+
+// -------------------------- closed sets of types -------------------------- //
+
+// the position of T in Ts... (the id of T)
+template<class T, class... Ts> struct IndexOf;
+
+template<class T, class... Ts>
+struct IndexOf<T, T, Ts...> { static constexpr std::size_t value = 0; };
+
+template<class T, class U, class... Ts>
+struct IndexOf<T, U, Ts...> {
+    static constexpr std::size_t value = 1 + IndexOf<T, Ts...>::value;
+};
+
+
+// An owning existential over the closed set Ts...: a heap-allocated value
+// and the id of its type.
+template<class... Ts>
+class Dyn {
+    static_assert(sizeof...(Ts) <= 256, "the id is a byte");
+
+    typedef void (*Drop)(void *);
+
+    template<class T>
+    static void drop(void * self) { delete static_cast<T *>(self); }
+
+    static constexpr Drop drops[sizeof...(Ts)] = { &drop<Ts>... };
+
+    void * self;
+    std::uint8_t id;
+
+public:
+    // not a copy constructor: Dyn is move-only
+    template<class T, class U = typename std::decay<T>::type,
+             class = typename std::enable_if<!std::is_same<U, Dyn>::value>::type>
+    Dyn(T && x): self(new U(std::forward<T>(x))), id(IndexOf<U, Ts...>::value) {}
+
+    Dyn(Dyn && other) noexcept: self(other.self), id(other.id) {
+        other.self = nullptr;
+    }
+
+    Dyn & operator=(Dyn && other) noexcept {
+        std::swap(self, other.self);
+        std::swap(id, other.id);
+        return *this;
+    }
+
+    ~Dyn() { if (self) drops[id](self); }
+
+    std::size_t type_id() const { return id; }
+    void const * get() const { return self; }
+};
+
+template<class... Ts>
+constexpr typename Dyn<Ts...>::Drop Dyn<Ts...>::drops[sizeof...(Ts)];
+
+
+// The table of a binary method: Op<A, B>::call(a, b) for all the pairs
+// of Ts..., indexed by the ids of A and B.
+template<template<class, class> class Op, class... Ts>
+struct DispatchTable2 {
+    typedef typename std::tuple_element<0, std::tuple<Ts...>>::type T0;
+    typedef decltype(Op<T0, T0>::call(std::declval<T0>(), std::declval<T0>())) R;
+    typedef R (*Fn)(void const *, void const *);
+
+    template<class A, class B>
+    static R entry(void const * a, void const * b) {
+        return Op<A, B>::call(*static_cast<A const *>(a), *static_cast<B const *>(b));
+    }
+
+    template<class A>
+    struct Row {
+        static constexpr std::array<Fn, sizeof...(Ts)> value = {{ &entry<A, Ts>... }};
+    };
+
+    static constexpr std::array<std::array<Fn, sizeof...(Ts)>, sizeof...(Ts)> table =
+        {{ Row<Ts>::value... }};
+};
+
+template<template<class, class> class Op, class... Ts>
+template<class A>
+constexpr std::array<typename DispatchTable2<Op, Ts...>::Fn, sizeof...(Ts)>
+DispatchTable2<Op, Ts...>::Row<A>::value;
+
+template<template<class, class> class Op, class... Ts>
+constexpr std::array<std::array<typename DispatchTable2<Op, Ts...>::Fn, sizeof...(Ts)>, sizeof...(Ts)>
+DispatchTable2<Op, Ts...>::table;
+
+// calls the entry of the types of a and b
+template<template<class, class> class Op, class... Ts>
+typename DispatchTable2<Op, Ts...>::R dispatch2(Dyn<Ts...> const & a, Dyn<Ts...> const & b) {
+    return DispatchTable2<Op, Ts...>::table[a.type_id()][b.type_id()](a.get(), b.get());
+}
+
+#endif // _EQ_DISPATCH_HPP_
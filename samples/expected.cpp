@@ -0,0 +1,102 @@
+#include <iostream>
+#include <string>
+#include <utility>
+#include <variant>
+#include <optional>
+#include <cstdlib>
+#include <new>
+#include <type_traits>
+#include <assert.h>
+#include "expected.hpp"
+#include "allocs.hpp" // allocations are counted to show that failures don't allocate
+
+// Errors as values (C++17): Functor/Applicative/Monad instances for an
+// expected-style Result<T> and for std::optional (expected.hpp).
+//
+// The typeclasses form a hierarchy of superclasses (cf. super.cpp).
+// A chain of binds stops at the first error: the following stages are
+// not called, nothing is thrown and nothing is allocated.
+
+
+// ---------------------------------- usage ---------------------------------- //
+
+Result<int> parse_int(char const * s) {
+    if (!*s) return unexpected(Error{ Errc::empty, "empty" });
+
+    bool negative = *s == '-';
+    if (negative) s++;
+
+    long long x = 0;
+    for (; *s; s++) {
+        if (*s < '0' || *s > '9') return unexpected(Error{ Errc::not_a_number, "not a number" });
+        x = x * 10 + (*s - '0');
+        if (x > 2147483647LL) return unexpected(Error{ Errc::overflow, "overflow" });
+    }
+    return int(negative ? -x : x);
+}
+
+Result<int> divide(int a, int b) {
+    if (b == 0) return unexpected(Error{ Errc::division_by_zero, "division by zero" });
+    return a / b;
+}
+
+// an optional version, without the reason of the failure
+template<class A>
+std::optional<A> to_optional(Result<A> x) {
+    if (!x) return std::nullopt;
+    return *x;
+}
+
+int stages = 0; // the number of stages run
+
+// a computation written once for any monad M
+template<template<class> class M, class Parse, class Div>
+M<int> ratio_plus_one(char const * a, char const * b, Parse parse, Div div) {
+    TC_IMPL(Monad<M>) MM;
+    TC_IMPL(Functor<M>) FM;
+
+    return FM::fmap(MM::bind(parse(a), [&](int x) {
+        stages++;
+        return MM::bind(parse(b), [&](int y) {
+            stages++;
+            return div(x, y);
+        });
+    }), [](int r) { stages++; return r + 1; });
+}
+
+
+int main() {
+    TC_IMPL(Applicative<Result>) AR;
+
+    std::size_t before = allocs;
+
+    Result<int> ok = ratio_plus_one<Result>("84", "2", parse_int, divide);
+    assert(ok && *ok == 43 && stages == 3);
+
+    // the chain stops at the first error
+    stages = 0;
+    Result<int> bad = ratio_plus_one<Result>("x84", "2", parse_int, divide);
+    assert(!bad && bad.error().code == Errc::not_a_number && stages == 0);
+
+    Result<int> zero = ratio_plus_one<Result>("84", "0", parse_int, divide);
+    assert(!zero && zero.error().code == Errc::division_by_zero);
+
+    // the same computation with std::optional
+    auto parse_opt = [](char const * s) { return to_optional(parse_int(s)); };
+    auto div_opt = [](int a, int b) { return to_optional(divide(a, b)); };
+    assert(*ratio_plus_one<std::optional>("84", "2", parse_opt, div_opt) == 43);
+    assert(!ratio_plus_one<std::optional>("84", "99999999999", parse_opt, div_opt));
+
+    // independent results
+    auto sum = AR::lift2([](int a, int b) { return a + b; }, parse_int("40"), parse_int("2"));
+    auto err = AR::lift2([](int a, int b) { return a + b; }, parse_int(""), parse_int("?"));
+    assert(*sum == 42 && err.error().code == Errc::empty);
+
+    assert(allocs == before); // no allocation at all
+
+    for (char const * s : { "84", "x", "", "0" }) {
+        Result<int> r = ratio_plus_one<Result>("84", s, parse_int, divide);
+        if (r) std::cout << *r << std::endl;
+        else std::cout << "error: " << r.error().what << std::endl;
+    }
+}
@@ -0,0 +1,155 @@
+// Functor/Applicative/Monad instances for an expected-style Result<T>
+// and for std::optional (C++17), shared by expected.cpp and
+// bench/expected.cpp.
+
+#ifndef _EXPECTED_HPP_
+#define _EXPECTED_HPP_
+
+#include <utility>
+#include <variant>
+#include <optional>
+#include <type_traits>
+#include "../tc.hpp"
+
+// T has the kind * -> *
+template<template<class> class T>
+struct Functor {
+    template<class A, class F>
+    static auto fmap(T<A> x, F f) -> T<decltype(f(std::declval<A>()))>
+    = delete;
+};
+
+template<template<class> class T>
+struct Applicative {
+    TC_REQUIRE(Functor<T>);
+
+    template<class A>
+    static T<A> pure(A x) = delete;
+
+    // lift2(f, a, b): f applied to the values of a and b
+    template<class A, class B, class F>
+    static auto lift2(F f, T<A> a, T<B> b) -> T<decltype(f(std::declval<A>(), std::declval<B>()))>
+    = delete;
+};
+
+template<template<class> class T>
+struct Monad {
+    TC_REQUIRE(Applicative<T>);
+
+    // bind(x, f) where f: A -> T<B>
+    template<class A, class F>
+    static auto bind(T<A> x, F f) -> decltype(f(std::declval<A>()))
+    = delete;
+};
+
+
+// ------------------------------- Expected ------------------------------- //
+
+template<class E>
+struct Unexpected {
+    E error;
+};
+
+template<class E>
+Unexpected<E> unexpected(E e) { return { std::move(e) }; }
+
+// either a value or an error
+template<class T, class E>
+class Expected {
+    std::variant<T, Unexpected<E>> v;
+
+public:
+    Expected(T x): v(std::in_place_index<0>, std::move(x)) {}
+    Expected(Unexpected<E> e): v(std::in_place_index<1>, std::move(e)) {}
+
+    bool has_value() const { return v.index() == 0; }
+    explicit operator bool() const { return has_value(); }
+
+    // unchecked accessors: check has_value() first
+    T & operator*() { return *std::get_if<0>(&v); }
+    T const & operator*() const { return *std::get_if<0>(&v); }
+    E const & error() const { return std::get_if<1>(&v)->error; }
+};
+
+// The error type is fixed, so that Result has the kind * -> *
+// (cf. Vec in functor.cpp).
+enum class Errc { empty, not_a_number, overflow, division_by_zero };
+
+struct Error {
+    Errc code;
+    char const * what; // a static string: no allocation
+};
+
+template<class T> using Result = Expected<T, Error>;
+
+
+template<>
+TC_INSTANCE(Functor<Result>, {
+    template<class A, class F>
+    static auto fmap(Result<A> x, F f) -> Result<decltype(f(std::declval<A>()))> {
+        if (!x) return unexpected(x.error());
+        return f(std::move(*x));
+    }
+});
+
+template<>
+TC_INSTANCE(Applicative<Result>, {
+    template<class A>
+    static Result<A> pure(A x) { return x; }
+
+    // the first error, if any
+    template<class A, class B, class F>
+    static auto lift2(F f, Result<A> a, Result<B> b)
+        -> Result<decltype(f(std::declval<A>(), std::declval<B>()))>
+    {
+        if (!a) return unexpected(a.error());
+        if (!b) return unexpected(b.error());
+        return f(std::move(*a), std::move(*b));
+    }
+});
+
+template<>
+TC_INSTANCE(Monad<Result>, {
+    template<class A, class F>
+    static auto bind(Result<A> x, F f) -> decltype(f(std::declval<A>())) {
+        if (!x) return unexpected(x.error());
+        return f(std::move(*x));
+    }
+});
+
+
+// ------------------------------ std::optional ------------------------------ //
+
+template<>
+TC_INSTANCE(Functor<std::optional>, {
+    template<class A, class F>
+    static auto fmap(std::optional<A> x, F f) -> std::optional<decltype(f(std::declval<A>()))> {
+        if (!x) return std::nullopt;
+        return f(std::move(*x));
+    }
+});
+
+template<>
+TC_INSTANCE(Applicative<std::optional>, {
+    template<class A>
+    static std::optional<A> pure(A x) { return x; }
+
+    template<class A, class B, class F>
+    static auto lift2(F f, std::optional<A> a, std::optional<B> b)
+        -> std::optional<decltype(f(std::declval<A>(), std::declval<B>()))>
+    {
+        if (!a || !b) return std::nullopt;
+        return f(std::move(*a), std::move(*b));
+    }
+});
+
+template<>
+TC_INSTANCE(Monad<std::optional>, {
+    template<class A, class F>
+    static auto bind(std::optional<A> x, F f) -> decltype(f(std::declval<A>())) {
+        if (!x) return std::nullopt;
+        return f(std::move(*x));
+    }
+});
+
+#endif // _EXPECTED_HPP_
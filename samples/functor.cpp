@@ -1,6 +1,8 @@
 #include <iostream>
 #include <utility>
 #include <vector>
+#include <memory>
+#include <type_traits>
 #include "../tc.hpp"
 
 // C++ has HKTs and C++11 facilitates their use with the ability to fix some
@@ -16,18 +18,44 @@ struct Functor {
 };
 
 
+// The instance accepts any std::vector<A, Alloc>, not only Vec<A>:
+// the allocator (e.g. a std::pmr::polymorphic_allocator) is rebound 
+// to the result element type and propagated to the result.
 template<> 
 TC_INSTANCE(Functor<Vec>, {    
-    template<class A, class F>
-    static auto fmap(Vec<A> xs, F f) -> Vec<decltype(f(std::declval<A>()))> {
-        decltype(fmap(xs,f)) res;
+    template<class A, class Alloc, class F, 
+             class B = decltype(std::declval<F &>()(std::declval<A const &>()))>
+    using Result = std::vector<B, 
+        typename std::allocator_traits<Alloc>::template rebind_alloc<B>>;
+
+    // a const lvalue: the elements are read in place 
+    // and the result is reserved up front
+    template<class A, class Alloc, class F>
+    static auto fmap(std::vector<A, Alloc> const & xs, F f) 
+        -> Result<A, Alloc, F> 
+    {
+        Result<A, Alloc, F> res(xs.get_allocator());
+        res.reserve(xs.size());
 
-        for (auto x : xs) {
+        for (auto const & x : xs) {
             res.push_back(f(x));
         }
             
         return res;
     }
+
+    // an rvalue mapped to the same type: the buffer is reused
+    template<class A, class Alloc, class F,
+             class = typename std::enable_if<
+                 std::is_same<typename Result<A, Alloc, F>::value_type, A>::value
+             >::type>
+    static std::vector<A, Alloc> fmap(std::vector<A, Alloc> && xs, F f) {
+        for (auto && x : xs) { // the elements of std::vector<bool> are proxies
+            x = f(std::move(x));
+        }
+
+        return std::move(xs);
+    }
 });
 
 
@@ -39,6 +67,19 @@ int main() {
     for (auto x: FV::fmap(foo, [](int x) { return x*x; })) {
         std::cout << x << std::endl;
     }
-}
 
+    // in-place: no allocations
+    int const * data = foo.data();
+    Vec<int> bar = FV::fmap(std::move(foo), [](int x) { return -x; });
+    std::cout << (bar.data() == data ? "reused" : "copied") << std::endl;
+
+    // a different element type: one allocation
+    for (auto x: FV::fmap(std::move(bar), [](int x) { return x * 0.5; })) {
+        std::cout << x << std::endl;
+    }
+
+    // in place over the proxies of std::vector<bool>
+    Vec<bool> flags = FV::fmap(Vec<bool>{true, false}, [](bool x) { return !x; });
+    std::cout << flags[0] << flags[1] << std::endl;
+}
 
@@ -0,0 +1,99 @@
+#include <iostream>
+#include <utility>
+#include <vector>
+#include <cstdlib>
+#include <new>
+#include <type_traits>
+#include <assert.h>
+#include "functor_lazy.hpp"
+#include "allocs.hpp" // allocations are counted to show the intermediate vectors
+
+// Lazy fmap pipelines (expression templates).
+//
+// Every call of the eager Functor<Vec>::fmap (functor.cpp) materializes
+// a vector, so a chain of k fmaps reads and writes the data k times.
+// Lazy<E> is a functor too, but fmap only records the function in the
+// type E of the pipeline; collect() (or a fold) runs the whole pipeline
+// in a single pass, fmaps and filters included, and materializes once
+// (functor_lazy.hpp).
+
+
+// the eager instance (cf. functor.cpp)
+template<>
+TC_INSTANCE(Functor<Vec>, {
+    template<class A, class F>
+    static auto fmap(Vec<A> const & xs, F f) -> Vec<decltype(f(std::declval<A>()))> {
+        Vec<decltype(f(std::declval<A>()))> res;
+        res.reserve(xs.size());
+        for (auto const & x : xs) res.push_back(f(x));
+        return res;
+    }
+});
+
+
+// The same code for any functor: with Vec every step is a pass over
+// a new vector, with Lazy the steps are fused.
+template<template<class> class T, class Xs>
+auto scale_shift_square(Xs const & xs) {
+    TC_IMPL(Functor<T>) F;
+    return F::fmap(F::fmap(F::fmap(xs,
+        [](int x) { return x * 3; }),
+        [](int x) { return x + 1; }),
+        [](int x) { return (long long)x * x; });
+}
+
+// a view of a temporary would dangle
+template<class V, class = void>
+struct can_view: std::false_type {};
+
+template<class V>
+struct can_view<V, decltype(void(lazy(std::declval<V>())))>: std::true_type {};
+
+static_assert(can_view<Vec<int> &>::value, "");
+static_assert(!can_view<Vec<int>>::value, "a temporary");
+
+
+int main() {
+    Vec<int> xs;
+    for (int i = 0; i < 1000; i++) xs.push_back(i);
+
+    auto add = [](long long acc, long long x) { return acc + x; };
+
+    // eager: three intermediate vectors
+    std::size_t before = allocs;
+    Vec<long long> eager = scale_shift_square<Vec>(xs);
+    std::size_t eager_allocs = allocs - before;
+
+    // lazy: one pass and one allocation
+    before = allocs;
+    Vec<long long> fused = collect(scale_shift_square<Lazy>(lazy(xs)));
+    std::size_t lazy_allocs = allocs - before;
+
+    assert(fused == eager);
+    assert(eager_allocs == 3 && lazy_allocs == 1);
+    std::cout << eager_allocs << " allocations vs " << lazy_allocs << std::endl;
+
+    // fmap, filter and fold in the same pass, no allocation at all
+    TC_IMPL(Functor<Lazy>) FL;
+    before = allocs;
+    auto odd_squares = FL::fmap(filter(FL::fmap(lazy(xs),
+        [](int x) { return x * 2 + 1; }),
+        [](int x) { return x % 3 != 0; }),
+        [](int x) { return (long long)x * x; });
+    long long sum = tc_impl_t<Foldable<Lazy>>::fold_left(odd_squares, 0LL, add);
+    assert(allocs == before);
+
+    Vec<long long> expected;
+    for (int x : xs) {
+        if ((x * 2 + 1) % 3 != 0) expected.push_back((long long)(x * 2 + 1) * (x * 2 + 1));
+    }
+    assert(sum == tc_impl_t<Foldable<Vec>>::fold_left(expected, 0LL, add));
+    assert(collect(odd_squares) == expected);
+
+    std::cout << sum << std::endl;
+
+    for (auto x: collect(filter(FL::fmap(lazy(xs), [](int x) { return x / 100.0; }),
+                                [](double x) { return x > 9.95; }))) {
+        std::cout << x << std::endl;
+    }
+}
@@ -0,0 +1,161 @@
+// Lazy fmap pipelines (expression templates), shared by functor_lazy.cpp
+// and bench/fmap_fused.cpp.
+//
+// Lazy<E> is a functor, but fmap only records the function in the type
+// E of the pipeline; collect() (or a fold) runs the whole pipeline in
+// a single pass, fmaps and filters included, and materializes once.
+//
+// The eager Functor<Vec> instance is left to the includer.
+
+#ifndef _FUNCTOR_LAZY_HPP_
+#define _FUNCTOR_LAZY_HPP_
+
+#include <utility>
+#include <vector>
+#include <type_traits>
+#include "../tc.hpp"
+
+template<class T> using Vec = std::vector<T>;
+
+// T has the kind * -> *
+template<template<class> class T>
+struct Functor {
+    template<class A, class F>
+    static auto fmap(T<A> xs, F f) -> T<decltype(f(std::declval<A>()))>
+    = delete;
+};
+
+template<template<class> class T>
+struct Foldable {
+    template<class A, class B, class F>
+    static B fold_left(T<A> const & xs, B init, F f) = delete;
+};
+
+
+// the eager fold (cf. monoid.cpp)
+template<>
+TC_INSTANCE(Foldable<Vec>, {
+    template<class A, class B, class F>
+    static B fold_left(Vec<A> const & xs, B init, F f) {
+        for (auto const & x : xs) init = f(init, x);
+        return init;
+    }
+});
+
+
+// ----------------------------- the pipelines ----------------------------- //
+
+// The nodes of a pipeline push their elements to a continuation k:
+// for_each(k) calls k(x) for every element x, and inlines down to
+// a single loop over the source.
+
+// a vector read in place (it must outlive the pipeline)
+template<class V>
+struct LazySource {
+    typedef typename V::value_type const & reference;
+    static constexpr bool exact_size = true;
+
+    V const * xs;
+
+    std::size_t size_hint() const { return xs->size(); }
+
+    template<class K>
+    void for_each(K && k) const {
+        for (auto const & x : *xs) k(x);
+    }
+};
+
+template<class E, class F>
+struct LazyMap {
+    typedef decltype(std::declval<F const &>()(std::declval<typename E::reference>())) reference;
+    static constexpr bool exact_size = E::exact_size;
+
+    E e;
+    F f;
+
+    std::size_t size_hint() const { return e.size_hint(); }
+
+    template<class K>
+    void for_each(K && k) const {
+        e.for_each([&](typename E::reference x) {
+            k(f(std::forward<typename E::reference>(x)));
+        });
+    }
+};
+
+template<class E, class P>
+struct LazyFilter {
+    typedef typename E::reference reference;
+    static constexpr bool exact_size = false;
+
+    E e;
+    P p;
+
+    std::size_t size_hint() const { return e.size_hint(); }
+
+    template<class K>
+    void for_each(K && k) const {
+        e.for_each([&](reference x) {
+            if (p(x)) k(std::forward<reference>(x));
+        });
+    }
+};
+
+// A lazy pipeline: the type parameter is the pipeline, not the type
+// of the elements, but the kind is * -> * and so Lazy is a functor.
+template<class E>
+struct Lazy {
+    typedef typename std::decay<typename E::reference>::type value_type;
+
+    E expr;
+};
+
+// a view of a vector
+template<class V>
+Lazy<LazySource<V>> lazy(V const & xs) {
+    return { { &xs } };
+}
+
+// the view would outlive a temporary vector
+template<class V>
+void lazy(V const &&) = delete;
+
+template<class E, class P>
+Lazy<LazyFilter<E, P>> filter(Lazy<E> xs, P p) {
+    return { { std::move(xs.expr), std::move(p) } };
+}
+
+// runs the pipeline, materializing the result once
+template<class E>
+Vec<typename Lazy<E>::value_type> collect(Lazy<E> const & xs) {
+    Vec<typename Lazy<E>::value_type> res;
+    if (E::exact_size) res.reserve(xs.expr.size_hint());
+
+    xs.expr.for_each([&](typename E::reference x) {
+        res.push_back(std::forward<typename E::reference>(x));
+    });
+
+    return res;
+}
+
+template<>
+TC_INSTANCE(Functor<Lazy>, {
+    template<class E, class F>
+    static Lazy<LazyMap<E, F>> fmap(Lazy<E> xs, F f) {
+        return { { std::move(xs.expr), std::move(f) } };
+    }
+});
+
+// a fold runs the pipeline without materializing it
+template<>
+TC_INSTANCE(Foldable<Lazy>, {
+    template<class E, class B, class F>
+    static B fold_left(Lazy<E> const & xs, B init, F f) {
+        xs.expr.for_each([&](typename E::reference x) {
+            init = f(init, std::forward<typename E::reference>(x));
+        });
+        return init;
+    }
+});
+
+#endif // _FUNCTOR_LAZY_HPP_
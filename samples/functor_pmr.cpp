@@ -0,0 +1,89 @@
+#include <iostream>
+#include <utility>
+#include <vector>
+#include <memory>
+#include <memory_resource>
+#include <type_traits>
+#include <assert.h>
+#include "../tc.hpp"
+
+// The Functor instance of functor.cpp used with std::pmr containers (C++17).
+
+// C++ has HKTs and C++11 facilitates their use with the ability to fix some
+// template arguments:
+template<class T> using Vec = std::vector<T>;
+
+// T has the kind * -> *
+template<template<class> class T>
+struct Functor {
+    template<class A, class F>
+    static auto fmap(T<A> xs, F f) -> T<decltype(f(std::declval<A>()))> 
+    = delete;
+};
+
+
+// The instance accepts any std::vector<A, Alloc>, not only Vec<A>:
+// the allocator (e.g. a std::pmr::polymorphic_allocator) is rebound 
+// to the result element type and propagated to the result.
+template<> 
+TC_INSTANCE(Functor<Vec>, {    
+    template<class A, class Alloc, class F, 
+             class B = decltype(std::declval<F &>()(std::declval<A const &>()))>
+    using Result = std::vector<B, 
+        typename std::allocator_traits<Alloc>::template rebind_alloc<B>>;
+
+    // a const lvalue: the elements are read in place 
+    // and the result is reserved up front
+    template<class A, class Alloc, class F>
+    static auto fmap(std::vector<A, Alloc> const & xs, F f) 
+        -> Result<A, Alloc, F> 
+    {
+        Result<A, Alloc, F> res(xs.get_allocator());
+        res.reserve(xs.size());
+
+        for (auto const & x : xs) {
+            res.push_back(f(x));
+        }
+            
+        return res;
+    }
+
+    // an rvalue mapped to the same type: the buffer is reused
+    template<class A, class Alloc, class F,
+             class = typename std::enable_if<
+                 std::is_same<typename Result<A, Alloc, F>::value_type, A>::value
+             >::type>
+    static std::vector<A, Alloc> fmap(std::vector<A, Alloc> && xs, F f) {
+        for (auto && x : xs) { // the elements of std::vector<bool> are proxies
+            x = f(std::move(x));
+        }
+
+        return std::move(xs);
+    }
+});
+
+
+int main() {
+    char buffer[1024];
+    std::pmr::monotonic_buffer_resource arena(buffer, sizeof(buffer));
+
+    std::pmr::vector<int> foo({1,2,3,4,5}, &arena);
+
+    TC_IMPL(Functor<Vec>) FV;
+
+    // the result is allocated from the same memory resource
+    auto squares = FV::fmap(foo, [](int x) { return x*x; });
+    assert(squares.get_allocator().resource() == &arena);
+
+    auto halves = FV::fmap(std::move(squares), [](int x) { return x * 0.5; });
+    static_assert(std::is_same<decltype(halves), std::pmr::vector<double>>::value, "");
+    assert(halves.get_allocator().resource() == &arena);
+
+    for (auto x: halves) {
+        std::cout << x << std::endl;
+    }
+
+    std::pmr::vector<bool> flags({true, false}, &arena);
+    flags = FV::fmap(std::move(flags), [](bool x) { return !x; });
+    assert(!flags[0] && flags[1]);
+}
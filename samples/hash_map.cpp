@@ -0,0 +1,172 @@
+#include <iostream>
+#include <utility>
+#include <vector>
+#include <tuple>
+#include <string>
+#include <initializer_list>
+#include <stdexcept>
+#include <assert.h>
+#include "hash_map.hpp"
+
+// Hash instances composed like Eq<std::pair<A,B>> of eq.cpp, used as 
+// keys of the flat hash map of hash_map.hpp.
+
+// pairs
+
+template<class A, class B> 
+TC_INSTANCE(TC(Eq<std::pair<A, B>>), {
+    TC_IMPL(Eq<A>) EA; 
+    TC_IMPL(Eq<B>) EB;
+
+    static bool equal(std::pair<A,B> const & pa, std::pair<A,B> const & pb) {
+        return
+            EA::equal(pa.first, pb.first) and
+            EB::equal(pa.second, pb.second);
+    }
+});
+
+template<class A, class B> 
+TC_INSTANCE(TC(Hash<std::pair<A, B>>), {
+    TC_IMPL(Hash<A>) HA; 
+    TC_IMPL(Hash<B>) HB;
+
+    static std::size_t hash(std::pair<A,B> const & p) {
+        return hash_combine(HA::hash(p.first), HB::hash(p.second));
+    }
+});
+
+
+// vectors
+
+template<class T> 
+TC_INSTANCE(Eq<std::vector<T>>, {
+    static bool equal(std::vector<T> const & a, std::vector<T> const & b) {
+        if (a.size() != b.size()) return false;
+        for (std::size_t i = 0; i < a.size(); i++) {
+            if (!tc_impl_t<Eq<T>>::equal(a[i], b[i])) return false;
+        }
+        return true;
+    }
+});
+
+template<class T> 
+TC_INSTANCE(Hash<std::vector<T>>, {
+    static std::size_t hash(std::vector<T> const & xs) {
+        std::size_t h = hash_mix(xs.size());
+        for (auto const & x : xs) h = hash_combine(h, tc_impl_t<Hash<T>>::hash(x));
+        return h;
+    }
+});
+
+
+// tuples
+
+template<class... Ts> 
+TC_INSTANCE(Eq<std::tuple<Ts...>>, {
+    template<std::size_t... I>
+    static bool equal_impl(std::tuple<Ts...> const & a, std::tuple<Ts...> const & b, 
+                           std::index_sequence<I...>) {
+        bool res = true;
+        (void)std::initializer_list<int>{ 
+            (res = res && tc_impl_t<Eq<Ts>>::equal(std::get<I>(a), std::get<I>(b)), 0)... 
+        };
+        return res;
+    }
+
+    static bool equal(std::tuple<Ts...> const & a, std::tuple<Ts...> const & b) {
+        return equal_impl(a, b, std::index_sequence_for<Ts...>());
+    }
+});
+
+template<class... Ts> 
+TC_INSTANCE(Hash<std::tuple<Ts...>>, {
+    template<std::size_t... I>
+    static std::size_t hash_impl(std::tuple<Ts...> const & x, std::index_sequence<I...>) {
+        std::size_t h = 0;
+        (void)std::initializer_list<int>{ 
+            (h = hash_combine(h, tc_impl_t<Hash<Ts>>::hash(std::get<I>(x))), 0)... 
+        };
+        return h;
+    }
+
+    static std::size_t hash(std::tuple<Ts...> const & x) {
+        return hash_impl(x, std::index_sequence_for<Ts...>());
+    }
+});
+
+
+// a value whose constructor may throw
+struct Checked {
+    int x;
+    explicit Checked(int x): x(x) { if (x < 0) throw std::invalid_argument("negative"); }
+};
+
+
+// a value whose copy may throw (and which has no move constructor)
+struct Fragile {
+    static int copies_left;
+    int x;
+    Fragile(int x): x(x) {}
+    Fragile(Fragile const & o): x(o.x) { if (copies_left-- == 0) throw std::runtime_error("copy"); }
+};
+int Fragile::copies_left = 1000000;
+
+FlatMap<int, int> squares(int n) {
+    FlatMap<int, int> res;
+    for (int i = 0; i < n; i++) res.emplace(i, i * i);
+    return res;
+}
+
+
+int main() {
+    FlatMap<std::pair<int, int>, std::string> names;
+
+    names.emplace({1, 2}, "one-two");
+    names[{3, 4}] = "three-four";
+    assert(!names.emplace({1, 2}, "again"));
+
+    std::cout << *names.find({1, 2}) << std::endl;
+    std::cout << names[{3, 4}] << std::endl;
+    assert(names.find({2, 1}) == nullptr);
+
+    // many keys: rehashing, tombstones and reuse of deleted slots
+    FlatSet<std::vector<int>> seen;
+    for (int i = 0; i < 10000; i++) seen.emplace(std::vector<int>{i, i % 7});
+    for (int i = 0; i < 10000; i += 2) assert(seen.erase(std::vector<int>{i, i % 7}));
+    for (int i = 0; i < 10000; i++) {
+        assert((seen.find(std::vector<int>{i, i % 7}) != nullptr) == (i % 2 == 1));
+    }
+    for (int i = 0; i < 10000; i += 2) seen.emplace(std::vector<int>{i, i % 7});
+    std::cout << seen.size() << std::endl;
+
+    // a throwing constructor leaves the map unchanged
+    FlatMap<int, Checked> checked;
+    checked.emplace(1, 1);
+    bool thrown = false;
+    try { checked.emplace(2, -1); } catch (std::invalid_argument const &) { thrown = true; }
+    assert(thrown && checked.size() == 1 && checked.find(2) == nullptr);
+    for (int i = 3; i < 100; i++) checked.emplace(i, i); // rehashes skip the slot
+    assert(checked.size() == 98 && checked.find(50)->x == 50);
+
+    // a failed rehash keeps the old table
+    FlatMap<int, Fragile> fragile;
+    for (int i = 0; i < 14; i++) fragile.emplace(i, i); // full up to 7/8
+    Fragile::copies_left = 5;
+    thrown = false;
+    try { fragile.emplace(14, 14); } catch (std::runtime_error const &) { thrown = true; }
+    Fragile::copies_left = 1000000;
+    assert(thrown && fragile.size() == 14);
+    for (int i = 0; i < 14; i++) assert(fragile.find(i)->x == i);
+
+    // maps are moved, not copied
+    std::vector<FlatMap<int, int>> maps;
+    for (int n = 1; n < 50; n++) maps.push_back(squares(n));
+    FlatMap<int, int> last = std::move(maps.back());
+    maps.back() = squares(3);
+    assert(last.size() == 49 && *last.find(7) == 49 && maps.back().size() == 3);
+    assert(maps[9].size() == 10 && *maps[9].find(9) == 81);
+
+    FlatMap<std::tuple<int, int, int>, int> counts;
+    for (int i = 0; i < 100; i++) counts[std::make_tuple(i % 3, i % 5, 0)]++;
+    std::cout << counts[std::make_tuple(0, 0, 0)] << std::endl;
+}
@@ -0,0 +1,265 @@
+// A Hash typeclass and a flat open-addressing hash map taking hashing 
+// and equality from the Hash and Eq instances of the key type (no 
+// std::hash needed), shared by hash_map.cpp and bench/hash_map.cpp.
+//
+// The table stores the entries in a single array (no per-node 
+// allocations) and probes groups of 16 control bytes at once.
+
+#ifndef _HASH_MAP_HPP_
+#define _HASH_MAP_HPP_
+
+#include <utility>
+#include <tuple>
+#include <new>
+#include <cstdint>
+#include "../tc.hpp"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+template<class T>
+struct Eq {
+    static bool equal(T const & a, T const & b) = delete;
+};
+
+template<class T>
+struct Hash {
+    TC_REQUIRE(Eq<T>); // equal values must have equal hashes
+
+    static std::size_t hash(T const & x) = delete;
+};
+
+
+// mixing of hash values
+
+inline std::size_t hash_mix(std::uint64_t h) {
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    return std::size_t(h);
+}
+
+inline std::size_t hash_combine(std::size_t seed, std::size_t h) {
+    return hash_mix(seed * 0x9E3779B97F4A7C15ULL + h);
+}
+
+
+// int
+
+template<> 
+TC_INSTANCE(Eq<int>, {
+    static bool equal(int const & a, int const & b) {
+        return a == b;
+    }
+});
+
+template<> 
+TC_INSTANCE(Hash<int>, {
+    static std::size_t hash(int const & x) {
+        return hash_mix(std::uint64_t(unsigned(x)));
+    }
+});
+
+
+// A flat hash map with SIMD group probing.
+//
+// Every slot has a control byte: EMPTY, DELETED or the lower 7 bits 
+// of the hash of the key (then the slot is full). Lookups compare 
+// the control bytes of a group of 16 slots with a single instruction 
+// and check the keys only for the matching slots.
+template<class K, class V>
+class FlatMap {
+    TC_IMPL(Hash<K>) H;
+    TC_IMPL(Eq<K>) E;
+
+    typedef std::pair<K, V> Entry;
+
+    static constexpr std::size_t group = 16;
+    static constexpr signed char EMPTY = -128;
+    static constexpr signed char DELETED = -2;
+
+    signed char * ctrl = nullptr;
+    Entry * slots = nullptr;
+    std::size_t cap = 0, count = 0, tombstones = 0;
+
+    // bit i is set iff the i-th control byte of the group equals b
+    static unsigned match(signed char const * g, signed char b) {
+#if defined(__SSE2__)
+        __m128i c = _mm_loadu_si128((__m128i const *)g);
+        return unsigned(_mm_movemask_epi8(_mm_cmpeq_epi8(c, _mm_set1_epi8(b))));
+#else
+        unsigned mask = 0;
+        for (unsigned i = 0; i < group; i++) mask |= unsigned(g[i] == b) << i;
+        return mask;
+#endif
+    }
+
+    // bit i is set iff the i-th slot of the group is EMPTY or DELETED
+    static unsigned match_free(signed char const * g) {
+#if defined(__SSE2__)
+        return unsigned(_mm_movemask_epi8(_mm_loadu_si128((__m128i const *)g)));
+#else
+        unsigned mask = 0;
+        for (unsigned i = 0; i < group; i++) mask |= unsigned(g[i] < 0) << i;
+        return mask;
+#endif
+    }
+
+    static signed char h2(std::size_t h) { return static_cast<signed char>(h & 0x7F); }
+
+    // calls f(group offset) along the probe sequence until f returns true
+    template<class F>
+    void probe(std::size_t h, F f) const {
+        std::size_t mask = cap / group - 1;
+        std::size_t g = (h >> 7) & mask;
+        for (std::size_t step = 1; !f(g * group); g = (g + step++) & mask) {}
+    }
+
+    std::size_t find_index(K const & k, std::size_t h) const {
+        std::size_t res = cap;
+        if (cap == 0) return res;
+
+        probe(h, [&](std::size_t g) {
+            for (unsigned m = match(ctrl + g, h2(h)); m; m &= m - 1) {
+                std::size_t i = g + __builtin_ctz(m);
+                if (E::equal(slots[i].first, k)) { res = i; return true; }
+            }
+            return match(ctrl + g, EMPTY) != 0;
+        });
+
+        return res;
+    }
+
+    std::size_t free_index(std::size_t h) const {
+        std::size_t res = 0;
+        probe(h, [&](std::size_t g) {
+            unsigned m = match_free(ctrl + g);
+            if (m) res = g + __builtin_ctz(m);
+            return m != 0;
+        });
+        return res;
+    }
+
+    // The new table is built aside and replaces the old one only when
+    // all the entries are in it: if a copy (or a move, when the entries
+    // can't be copied) throws, the map is left as it was.
+    void rehash(std::size_t new_cap) {
+        signed char * new_ctrl = new signed char[new_cap];
+        Entry * new_slots;
+        try {
+            new_slots = static_cast<Entry *>(::operator new(new_cap * sizeof(Entry)));
+        } catch (...) {
+            delete [] new_ctrl;
+            throw;
+        }
+        for (std::size_t i = 0; i < new_cap; i++) new_ctrl[i] = EMPTY;
+
+        FlatMap res;
+        res.ctrl = new_ctrl;
+        res.slots = new_slots;
+        res.cap = new_cap;
+
+        // res destroys the entries already moved if one throws
+        for (std::size_t i = 0; i < cap; i++) {
+            if (ctrl[i] >= 0) {
+                std::size_t h = H::hash(slots[i].first);
+                std::size_t j = res.free_index(h);
+                ::new (&res.slots[j]) Entry(std::move_if_noexcept(slots[i]));
+                res.ctrl[j] = h2(h);
+                res.count++;
+            }
+        }
+
+        swap(res);
+    }
+
+public:
+    FlatMap() {}
+    FlatMap(FlatMap const &) = delete;
+    FlatMap & operator=(FlatMap const &) = delete;
+
+    FlatMap(FlatMap && other) noexcept { swap(other); }
+
+    FlatMap & operator=(FlatMap && other) noexcept {
+        FlatMap(std::move(other)).swap(*this);
+        return *this;
+    }
+
+    ~FlatMap() {
+        for (std::size_t i = 0; i < cap; i++) {
+            if (ctrl[i] >= 0) slots[i].~Entry();
+        }
+        delete [] ctrl;
+        ::operator delete(slots);
+    }
+
+    void swap(FlatMap & other) noexcept {
+        std::swap(ctrl, other.ctrl);
+        std::swap(slots, other.slots);
+        std::swap(cap, other.cap);
+        std::swap(count, other.count);
+        std::swap(tombstones, other.tombstones);
+    }
+
+    std::size_t size() const { return count; }
+
+    V * find(K const & k) {
+        std::size_t i = find_index(k, H::hash(k));
+        return i == cap ? nullptr : &slots[i].second;
+    }
+
+    V const * find(K const & k) const {
+        return const_cast<FlatMap *>(this)->find(k);
+    }
+
+    // returns false (and keeps the old value) if the key is present
+    template<class... Args>
+    bool emplace(K const & k, Args && ... args) {
+        std::size_t h = H::hash(k);
+        if (find_index(k, h) != cap) return false;
+
+        // the load factor is at most 7/8
+        if ((count + tombstones + 1) * 8 > cap * 7) {
+            rehash(cap == 0 ? group : (count + 1) * 8 > cap * 7 / 2 ? cap * 2 : cap);
+        }
+
+        // the slot is marked full only once the entry is constructed
+        std::size_t i = free_index(h);
+        ::new (&slots[i]) Entry(std::piecewise_construct, 
+            std::forward_as_tuple(k), std::forward_as_tuple(std::forward<Args>(args)...));
+        if (ctrl[i] == DELETED) tombstones--;
+        ctrl[i] = h2(h);
+        count++;
+        return true;
+    }
+
+    V & operator[](K const & k) {
+        if (V * v = find(k)) return *v;
+        emplace(k);
+        return *find(k);
+    }
+
+    bool erase(K const & k) {
+        std::size_t i = find_index(k, H::hash(k));
+        if (i == cap) return false;
+        slots[i].~Entry();
+        ctrl[i] = DELETED;
+        count--;
+        tombstones++;
+        return true;
+    }
+
+    template<class F>
+    void for_each(F f) const {
+        for (std::size_t i = 0; i < cap; i++) {
+            if (ctrl[i] >= 0) f(slots[i].first, slots[i].second);
+        }
+    }
+};
+
+// a set is a map to nothing
+struct Unit {};
+template<class K> using FlatSet = FlatMap<K, Unit>;
+
+#endif // _HASH_MAP_HPP_
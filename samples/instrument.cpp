@@ -0,0 +1,136 @@
+// the instrumentation mode: must be enabled before including tc.hpp
+#define TC_INSTRUMENT
+#define TC_INSTRUMENT_TIMING
+#define TC_INSTRUMENT_NO_REPORT // reported below, on demand
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <assert.h>
+#include "../tc.hpp"
+
+// Counting the calls of the methods of selected instances
+// (tc_instrument.hpp): TC_INSTANCE_PROBED marks a whole instance,
+// TC_PROBE() a single method. The counters are reported on demand, or
+// at exit on stderr unless TC_INSTRUMENT_NO_REPORT is defined.
+//
+// Without TC_INSTRUMENT the probes expand to nothing.
+
+template<class T>
+struct Show {
+    static std::string show(T const &) = delete;
+};
+
+template<class T>
+struct Eq {
+    static bool equal(T const & a, T const & b) = delete;
+
+    static bool not_equal(T const & a, T const & b) {
+        return !tc_impl_t<Eq<T>>::equal(a, b);
+    }
+};
+
+template<>
+TC_INSTANCE(Show<int>, {
+    static std::string show(int const & x) {
+        TC_PROBE();
+        return std::to_string(x);
+    }
+});
+
+template<>
+TC_INSTANCE(Eq<int>, {
+    static bool equal(int const & a, int const & b) {
+        TC_PROBE();
+        return a == b;
+    }
+});
+
+// selected instances: every listed method, keyed by the instance type
+#define EQ_METHODS(m) \
+    m(equal, bool(T const &)) \
+    m(not_equal, bool(T const &))
+
+struct Point { int x, y; };
+
+template<>
+TC_INSTANCE_PROBED(Eq<Point>, EQ_METHODS, {
+    static bool equal(Point const & a, Point const & b) {
+        return a.x == b.x && a.y == b.y;
+    }
+});
+
+template<class T>
+struct Wrap { T value; };
+
+template<class T>
+TC_INSTANCE_PROBED(Eq<Wrap<T>>, EQ_METHODS, {
+    static bool equal(Wrap<T> const & a, Wrap<T> const & b) {
+        return tc_impl_t<Eq<T>>::equal(a.value, b.value);
+    }
+});
+
+// not probed
+template<>
+TC_INSTANCE(Eq<char>, {
+    static bool equal(char const & a, char const & b) { return a == b; }
+});
+
+template<class T>
+TC_INSTANCE(Show<std::vector<T>>, {
+    static std::string show(std::vector<T> const & xs) {
+        TC_PROBE(); // one counter per instantiation
+        std::string res = "[";
+        for (auto const & x : xs) {
+            if (res.size() > 1) res += ",";
+            res += tc_impl_t<Show<T>>::show(x);
+        }
+        return res + "]";
+    }
+});
+
+
+// the calls of a probed method, "<instance type>::<method>"
+unsigned long long calls_of(char const * key) {
+    return tc_probe_snapshot()[key].calls;
+}
+
+
+int main() {
+    std::vector<int> xs = {1, 2, 3};
+    std::cout << tc_impl_t<Show<std::vector<int>>>::show(xs) << std::endl;
+
+    // counters of several threads (merged when the threads exit)
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([] {
+            for (int i = 0; i < 1000; i++) {
+                tc_impl_t<Eq<int>>::equal(i, 0);
+                tc_impl_t<Eq<char>>::equal('a', 'b');
+            }
+        });
+    }
+    for (auto & t : threads) t.join();
+
+    // keyed by the instance type, with the template arguments, and the method
+    assert(calls_of("Show<int>::show") == 3);
+    assert(calls_of("Show<std::vector<int>>::show") == 1);
+    assert(calls_of("Eq<int>::equal") == 4000);
+    assert(calls_of("Eq<char>::equal") == 0);
+
+    // whole instances: the default not_equal calls equal through tc_impl_t
+    Point p{1, 2};
+    assert(tc_impl_t<Eq<Point>>::equal(p, p));
+    assert(!tc_impl_t<Eq<Point>>::not_equal(p, p));
+    assert(calls_of("Eq<Point>::equal") == 2);
+    assert(calls_of("Eq<Point>::not_equal") == 1);
+
+    Wrap<int> w{1};
+    assert(tc_impl_t<Eq<Wrap<int>>>::equal(w, w));
+    assert(calls_of("Eq<Wrap<int>>::equal") == 1);
+    assert(calls_of("Eq<int>::equal") == 4001);
+
+    // a report on demand
+    tc_probe_report(stdout);
+}
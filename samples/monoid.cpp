@@ -0,0 +1,89 @@
+#include <iostream>
+#include <utility>
+#include <vector>
+#include <stdexcept>
+#include <algorithm>
+#include <limits>
+#include <assert.h>
+#include "monoid.hpp"
+
+// Semigroup, Monoid and Foldable typeclasses (monoid.hpp): sequential
+// and parallel folds.
+
+// a Semigroup which is not a Monoid
+struct Min { int value; };
+
+template<>
+TC_INSTANCE(Semigroup<Min>, {
+    static Min append(Min const & a, Min const & b) {
+        return a.value <= b.value ? a : b;
+    }
+});
+
+// a Monoid without a default constructor: only empty() makes one
+struct Max {
+    int value;
+    explicit Max(int x): value(x) {}
+};
+
+template<>
+TC_INSTANCE(Semigroup<Max>, {
+    static Max append(Max const & a, Max const & b) {
+        return a.value >= b.value ? a : b;
+    }
+});
+
+template<>
+TC_INSTANCE(Monoid<Max>, {
+    static Max empty() { return Max(std::numeric_limits<int>::min()); }
+});
+
+
+int main() {
+    TC_IMPL(Foldable<Vec>) FV;
+    auto id = [](auto const & x) { return x; };
+
+    Vec<int> xs(1000000);
+    for (std::size_t i = 0; i < xs.size(); i++) xs[i] = int(i % 1000) - 500;
+
+    auto to_ll = [](int x) { return (long long)x * x; };
+    long long seq = FV::fold_map(xs, to_ll);
+    long long par = FV::par_fold_map(xs, to_ll, 4, 1000);
+    assert(seq == par);
+    std::cout << seq << std::endl;
+
+    // component-wise: (count, sum)
+    auto stats = FV::par_fold_map(xs, [](int x) { return std::make_pair(1, double(x)); }, 4, 1000);
+    std::cout << stats.first << std::endl;
+    std::cout << stats.second << std::endl;
+
+    // concatenation is associative but not commutative: the order is kept
+    Vec<Vec<int>> xss(10000);
+    for (std::size_t i = 0; i < xss.size(); i++) xss[i] = { int(i) };
+    Vec<int> flat = FV::par_fold_map(xss, id, 8, 100);
+    assert(std::is_sorted(flat.begin(), flat.end()) && flat.size() == xss.size());
+
+    auto max = FV::par_fold_map(xs, [](int x) { return Max(x); }, 4, 1000);
+    assert(max.value == FV::fold_map(xs, [](int x) { return Max(x); }).value);
+
+    // any arithmetic type
+    assert(FV::fold_map(Vec<float>{0.5f, 1.5f}, id) == 2.0f);
+    assert(FV::fold_map(Vec<short>{1, 2, 3}, id) == 6);
+    assert(FV::par_fold_map(Vec<unsigned long>(5000, 2), id, 4, 1000) == 10000);
+
+    // an exception of a worker thread is rethrown by the caller
+    bool caught = false;
+    try {
+        FV::par_fold_map(xs, [](int x) {
+            if (x == 499) throw std::runtime_error("499");
+            return x;
+        }, 4, 1000);
+    } catch (std::runtime_error const &) {
+        caught = true;
+    }
+    assert(caught);
+
+    // only a Semigroup
+    std::cout << FV::fold1_map(xs, [](int x) { return Min{x}; }).value << std::endl;
+    // FV::fold_map(xs, [](int x) { return Min{x}; }); // won't compile: no Monoid Min
+}
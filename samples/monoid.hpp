@@ -0,0 +1,197 @@
+// Semigroup, Monoid and Foldable typeclasses, shared by monoid.cpp and
+// bench/fold.cpp.
+//
+// The associativity of Semigroup::append allows to reduce chunks of 
+// a container independently and to combine the partial results in a tree;
+// the Monoid::empty element makes this possible for empty chunks. 
+// Sequential folds over non-empty containers need only a Semigroup.
+
+#ifndef _MONOID_HPP_
+#define _MONOID_HPP_
+
+#include <utility>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <exception>
+#include <algorithm>
+#include <type_traits>
+#include <assert.h>
+#include "../tc.hpp"
+
+template<class T> using Vec = std::vector<T>;
+
+template<class T>
+struct Semigroup {
+    // must be associative
+    static T append(T const & a, T const & b) = delete;
+};
+
+template<class T>
+struct Monoid {
+    TC_REQUIRE(Semigroup<T>); // a superclass (cf. super.cpp)
+
+    // append(empty(), x) == append(x, empty()) == x
+    static T empty() = delete;
+};
+
+
+// numbers under addition: the arithmetic types, except bool
+
+template<class T>
+using IsNumber = std::enable_if<(std::is_arithmetic<T>::value && 
+                                 !std::is_same<T, bool>::value)>;
+
+template<class T>
+TC_INSTANCE_IF(Semigroup<T>, typename IsNumber<T>::type, {
+    static T append(T const & a, T const & b) { return T(a + b); }
+});
+
+template<class T>
+TC_INSTANCE_IF(Monoid<T>, typename IsNumber<T>::type, {
+    static T empty() { return T(0); }
+});
+
+// pairs: component-wise (cf. Eq<std::pair> in eq.cpp)
+
+template<class A, class B>
+TC_INSTANCE(TC(Semigroup<std::pair<A, B>>), {
+    static std::pair<A, B> append(std::pair<A, B> const & a, std::pair<A, B> const & b) {
+        return { tc_impl_t<Semigroup<A>>::append(a.first, b.first),
+                 tc_impl_t<Semigroup<B>>::append(a.second, b.second) };
+    }
+});
+
+template<class A, class B>
+TC_INSTANCE(TC(Monoid<std::pair<A, B>>), {
+    static std::pair<A, B> empty() {
+        return { tc_impl_t<Monoid<A>>::empty(), tc_impl_t<Monoid<B>>::empty() };
+    }
+});
+
+// vectors: concatenation
+
+template<class T>
+TC_INSTANCE(Semigroup<Vec<T>>, {
+    static Vec<T> append(Vec<T> const & a, Vec<T> const & b) {
+        Vec<T> res;
+        res.reserve(a.size() + b.size());
+        res.insert(res.end(), a.begin(), a.end());
+        res.insert(res.end(), b.begin(), b.end());
+        return res;
+    }
+});
+
+template<class T>
+TC_INSTANCE(Monoid<Vec<T>>, {
+    static Vec<T> empty() { return {}; }
+});
+
+
+// T has the kind * -> *
+template<template<class> class T>
+struct Foldable {
+    template<class A, class B, class F>
+    static B fold_left(T<A> const & xs, B init, F f) = delete;
+
+    // fold_map :: Monoid m => (a -> m) -> t a -> m
+    template<class A, class G>
+    static auto fold_map(T<A> const & xs, G g) -> decltype(g(std::declval<A>())) {
+        typedef decltype(g(std::declval<A>())) M;
+        TC_IMPL(Monoid<M>) MM;
+        TC_IMPL(Semigroup<M>) SM;
+
+        return tc_impl_t<Foldable<T>>::fold_left(xs, MM::empty(), 
+            [&](M const & acc, A const & x) { return SM::append(acc, g(x)); });
+    }
+};
+
+template<>
+TC_INSTANCE(Foldable<Vec>, {
+    template<class A, class B, class F>
+    static B fold_left(Vec<A> const & xs, B init, F f) {
+        for (auto const & x : xs) init = f(init, x);
+        return init;
+    }
+
+    // a Semigroup suffices for a non-empty vector
+    template<class A, class G>
+    static auto fold1_map(Vec<A> const & xs, G g) -> decltype(g(std::declval<A>())) {
+        typedef decltype(g(std::declval<A>())) S;
+        assert(!xs.empty());
+
+        S acc = g(xs[0]);
+        for (std::size_t i = 1; i < xs.size(); i++) {
+            acc = tc_impl_t<Semigroup<S>>::append(acc, g(xs[i]));
+        }
+        return acc;
+    }
+
+    // Parallel fold_map: the range is split into at most `threads` chunks
+    // of at least `grain` elements, each reduced by its own thread (the
+    // first one by the calling thread). The partial results are combined
+    // pairwise in a tree, so only associativity is used (the order of
+    // elements is kept) and a concatenation copies every element
+    // log2(chunks) times rather than up to `chunks` times.
+    //
+    // All the threads are joined before the first exception thrown by
+    // `g` or `append` (in the order of the chunks) is rethrown.
+    template<class A, class G>
+    static auto par_fold_map(Vec<A> const & xs, G g, unsigned threads, 
+                             std::size_t grain = 1 << 16) 
+        -> decltype(g(std::declval<A>())) 
+    {
+        typedef decltype(g(std::declval<A>())) M;
+        TC_IMPL(Monoid<M>) MM;
+        TC_IMPL(Semigroup<M>) SM;
+
+        std::size_t n = xs.size();
+        std::size_t chunks = std::min<std::size_t>(std::max(1u, threads), 
+                                                   std::max<std::size_t>(1, n / std::max<std::size_t>(1, grain)));
+        std::size_t chunk = (n + chunks - 1) / chunks;
+
+        // a deque: the partial results are distinct objects even for
+        // bool, which std::vector would pack into shared words
+        std::deque<M> parts(chunks, MM::empty());
+        std::vector<std::exception_ptr> errors(chunks);
+
+        auto reduce = [&](std::size_t c) {
+            try {
+                M part = MM::empty();
+                std::size_t end = std::min(n, (c + 1) * chunk);
+                for (std::size_t i = c * chunk; i < end; i++) {
+                    part = SM::append(part, g(xs[i]));
+                }
+                parts[c] = std::move(part);
+            } catch (...) {
+                errors[c] = std::current_exception();
+            }
+        };
+
+        // a chunk whose thread can't be started is reduced in place
+        std::vector<std::thread> workers;
+        workers.reserve(chunks);
+        for (std::size_t c = 1; c < chunks; c++) {
+            try {
+                workers.emplace_back(reduce, c);
+            } catch (...) {
+                reduce(c);
+            }
+        }
+        reduce(0);
+        for (auto & w : workers) w.join();
+
+        for (auto & e : errors) {
+            if (e) std::rethrow_exception(e);
+        }
+
+        for (std::size_t step = 1; step < chunks; step *= 2) {
+            for (std::size_t c = 0; c + step < chunks; c += 2 * step) {
+                parts[c] = SM::append(parts[c], parts[c + step]);
+            }
+        }
+        return std::move(parts[0]);
+    }
+});
+
+#endif // _MONOID_HPP_
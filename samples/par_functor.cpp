@@ -0,0 +1,78 @@
+#include <iostream>
+#include <stdexcept>
+#include <assert.h>
+#include "par_functor.hpp"
+
+// ParFunctor (par_functor.hpp): the Vec instance maps large inputs
+// on a thread pool, other functors fall back to their Functor instance.
+
+// A functor without a parallel implementation.
+template<class A> struct Box { A value; };
+
+template<> 
+TC_INSTANCE(Functor<Box>, {    
+    template<class A, class F>
+    static auto fmap(Box<A> const & x, F f) -> Box<decltype(f(std::declval<A>()))> {
+        return { f(x.value) };
+    }
+});
+
+template<> TC_INSTANCE(ParFunctor<Box>, {}); // the default par_fmap
+
+
+int main() {
+    ThreadPool pool(std::max(2u, std::thread::hardware_concurrency()));
+    ParPolicy policy{pool, 1000};
+
+    Vec<int> xs(100000);
+    for (std::size_t i = 0; i < xs.size(); i++) xs[i] = int(i);
+
+    TC_IMPL(ParFunctor<Vec>) PV;
+
+    auto squares = PV::par_fmap(policy, xs, [](int x) { return (long long)x * x; });
+
+    for (std::size_t i = 0; i < xs.size(); i++) {
+        assert(squares[i] == (long long)xs[i] * xs[i]);
+    }
+    std::cout << squares[99999] << std::endl;
+
+    // below the threshold
+    for (auto x : PV::par_fmap(policy, Vec<int>{1,2,3}, [](int x) { return x + 1; })) {
+        std::cout << x << std::endl;
+    }
+
+    // bool results are mapped into separate chunks (no shared words)
+    auto evens = PV::par_fmap(policy, xs, [](int x) { return x % 2 == 0; });
+    for (std::size_t i = 0; i < xs.size(); i++) assert(evens[i] == (i % 2 == 0));
+
+    // an exception of a worker is rethrown to the caller
+    bool thrown = false;
+    try {
+        PV::par_fmap(policy, xs, [](int x) {
+            if (x == 77777) throw std::runtime_error("77777");
+            return x;
+        });
+    } catch (std::runtime_error const &) {
+        thrown = true;
+    }
+    assert(thrown);
+
+    // a nested map runs sequentially in its thread
+    Vec<Vec<int>> rows(2000, Vec<int>(1000, 1));
+    auto sums = PV::par_fmap(policy, rows, [&](Vec<int> const & row) {
+        int sum = 0;
+        for (int x : PV::par_fmap(policy, row, [](int x) { return x * 2; })) sum += x;
+        return sum;
+    });
+    for (int sum : sums) assert(sum == 2000);
+
+    // concurrent maps on the same pool take turns
+    Vec<long long> other;
+    std::thread t([&] { other = PV::par_fmap(policy, xs, [](int x) { return x + 1LL; }); });
+    auto mine = PV::par_fmap(policy, xs, [](int x) { return x - 1LL; });
+    t.join();
+    for (std::size_t i = 0; i < xs.size(); i++) assert(other[i] == xs[i] + 1 && mine[i] == xs[i] - 1);
+
+    std::cout << tc_impl_t<ParFunctor<Box>>::par_fmap(policy, Box<int>{20}, 
+        [](int x) { return x * 2.5; }).value << std::endl;
+}
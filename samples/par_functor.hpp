@@ -0,0 +1,253 @@
+// A parallel variant of the Functor typeclass (cf. functor.cpp),
+// shared by par_functor.cpp and bench/par_functor.cpp.
+//
+// ParFunctor has a single method par_fmap which by default falls back
+// to the sequential Functor instance, so any Functor can be made
+// a ParFunctor by an empty instance. The Vec instance splits large
+// inputs into chunks processed by a thread pool.
+
+#ifndef _PAR_FUNCTOR_HPP_
+#define _PAR_FUNCTOR_HPP_
+
+#include <utility>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <exception>
+#include <iterator>
+#include <algorithm>
+#include <type_traits>
+#include "../tc.hpp"
+
+template<class T> using Vec = std::vector<T>;
+
+// T has the kind * -> *
+template<template<class> class T>
+struct Functor {
+    template<class A, class F>
+    static auto fmap(T<A> const & xs, F f) -> T<decltype(f(std::declval<A>()))>
+    = delete;
+};
+
+template<>
+TC_INSTANCE(Functor<Vec>, {
+    template<class A, class F>
+    static auto fmap(Vec<A> const & xs, F f) -> Vec<decltype(f(std::declval<A>()))> {
+        decltype(fmap(xs,f)) res;
+        res.reserve(xs.size());
+
+        for (auto const & x : xs) {
+            res.push_back(f(x));
+        }
+
+        return res;
+    }
+});
+
+
+// A fixed set of threads executing parallel loops. Iterations are
+// handed out one by one from a single counter shared by all the threads
+// (there are no per-thread queues and no work-stealing), so a thread
+// which has finished its work takes over the remaining chunks of
+// slower threads.
+//
+// The first exception thrown by an iteration cancels the iterations
+// not started yet and is rethrown by parallel_for.
+//
+// The pool runs one loop at a time: concurrent callers of parallel_for
+// wait for each other, and a parallel_for called from an iteration of
+// the same pool (a nested loop) runs sequentially in the calling thread.
+class ThreadPool {
+    std::vector<std::thread> workers;
+    std::mutex caller, mutex;
+    std::condition_variable wake, done;
+
+    void (*job)(void *, std::size_t) = nullptr;
+    void * job_data = nullptr;
+    std::size_t job_size = 0;
+    std::atomic<std::size_t> next{0};
+    std::size_t busy = 0;
+    unsigned generation = 0;
+    bool stop = false;
+    std::exception_ptr error;
+
+    void work() {
+        for (std::size_t i; (i = next++) < job_size; ) {
+            try {
+                job(job_data, i);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (!error) error = std::current_exception();
+                next = job_size;
+            }
+        }
+    }
+
+    // the pool whose loop the current thread is running, if any
+    static ThreadPool *& current() {
+        static thread_local ThreadPool * pool = nullptr;
+        return pool;
+    }
+
+    void worker_loop() {
+        current() = this;
+        unsigned seen = 0;
+
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wake.wait(lock, [&]{ return stop || generation != seen; });
+                if (stop) return;
+                seen = generation;
+            }
+
+            work();
+
+            std::lock_guard<std::mutex> lock(mutex);
+            if (--busy == 0) done.notify_one();
+        }
+    }
+
+public:
+    // the calling thread is one of the `threads`
+    explicit ThreadPool(unsigned threads) {
+        for (unsigned i = 1; i < threads; i++) {
+            workers.emplace_back([this]{ worker_loop(); });
+        }
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stop = true;
+        }
+        wake.notify_all();
+        for (auto & w : workers) w.join();
+    }
+
+    unsigned size() const { return unsigned(workers.size()) + 1; }
+
+    // calls f(i) for every i in [0, n)
+    template<class F>
+    void parallel_for(std::size_t n, F f) {
+        if (current() == this) {
+            for (std::size_t i = 0; i < n; i++) f(i);
+            return;
+        }
+
+        std::lock_guard<std::mutex> one_loop(caller);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            job = [](void * data, std::size_t i) { (*static_cast<F *>(data))(i); };
+            job_data = &f;
+            job_size = n;
+            next = 0;
+            busy = workers.size();
+            error = nullptr;
+            generation++;
+        }
+        wake.notify_all();
+
+        ThreadPool * outer = current();
+        current() = this;
+        work();
+        current() = outer;
+
+        std::unique_lock<std::mutex> lock(mutex);
+        done.wait(lock, [&]{ return busy == 0; });
+        if (error) std::rethrow_exception(std::move(error));
+    }
+};
+
+
+// How to run a parallel map: inputs shorter than `threshold`
+// are mapped sequentially.
+struct ParPolicy {
+    ThreadPool & pool;
+    std::size_t threshold;
+};
+
+
+template<template<class> class T>
+struct ParFunctor {
+    template<class A, class F>
+    static auto par_fmap(ParPolicy const &, T<A> const & xs, F f)
+        -> T<decltype(f(std::declval<A>()))>
+    {
+        return tc_impl_t<Functor<T>>::fmap(xs, f);
+    }
+};
+
+template<>
+TC_INSTANCE(ParFunctor<Vec>, {
+    template<class A, class F>
+    static auto par_fmap(ParPolicy const & policy, Vec<A> const & xs, F f)
+        -> Vec<decltype(f(std::declval<A>()))>
+    {
+        typedef decltype(f(std::declval<A>())) B;
+
+        if (xs.size() < policy.threshold || policy.pool.size() == 1) {
+            return tc_impl_t<Functor<Vec>>::fmap(xs, f);
+        }
+
+        // several chunks per thread for load balancing,
+        // but none shorter than a half of the threshold
+        std::size_t chunks = std::min<std::size_t>(
+            policy.pool.size() * 4,
+            std::max<std::size_t>(1, xs.size() / std::max<std::size_t>(1, policy.threshold / 2)));
+        std::size_t chunk = (xs.size() + chunks - 1) / chunks;
+
+        // std::vector<bool> is bit-packed: neighbouring chunks would
+        // write the same words
+        typedef std::integral_constant<bool,
+            std::is_default_constructible<B>::value && !std::is_same<B, bool>::value> in_place;
+
+        return map_chunks(policy.pool, xs, f, chunks, chunk, in_place());
+    }
+
+    // every chunk writes its own part of the result: the order is kept
+    template<class A, class F>
+    static auto map_chunks(ThreadPool & pool, Vec<A> const & xs, F & f,
+                           std::size_t chunks, std::size_t chunk, std::true_type)
+        -> Vec<decltype(f(std::declval<A>()))>
+    {
+        Vec<decltype(f(std::declval<A>()))> res(xs.size());
+
+        pool.parallel_for(chunks, [&](std::size_t c) {
+            std::size_t end = std::min(xs.size(), (c + 1) * chunk);
+            for (std::size_t i = c * chunk; i < end; i++) {
+                res[i] = f(xs[i]);
+            }
+        });
+
+        return res;
+    }
+
+    // every chunk is mapped into its own vector, then they are joined
+    template<class A, class F>
+    static auto map_chunks(ThreadPool & pool, Vec<A> const & xs, F & f,
+                           std::size_t chunks, std::size_t chunk, std::false_type)
+        -> Vec<decltype(f(std::declval<A>()))>
+    {
+        std::vector<Vec<decltype(f(std::declval<A>()))>> parts(chunks);
+
+        pool.parallel_for(chunks, [&](std::size_t c) {
+            std::size_t end = std::min(xs.size(), (c + 1) * chunk);
+            if (c * chunk < end) parts[c].reserve(end - c * chunk);
+            for (std::size_t i = c * chunk; i < end; i++) {
+                parts[c].push_back(f(xs[i]));
+            }
+        });
+
+        Vec<decltype(f(std::declval<A>()))> res;
+        res.reserve(xs.size());
+        for (auto & part : parts) {
+            std::move(part.begin(), part.end(), std::back_inserter(res));
+        }
+        return res;
+    }
+});
+
+#endif // _PAR_FUNCTOR_HPP_
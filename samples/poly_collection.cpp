@@ -0,0 +1,175 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <initializer_list>
+#include "../tc.hpp"
+
+// A type-segregated collection of heterogeneous instances of a typeclass
+// (cf. Vec<Box<dyn Show>> in show.cpp).
+//
+// Each concrete type is stored in its own contiguous segment and 
+// iteration goes segment by segment, so inside a segment every call 
+// to a typeclass method is resolved statically: a megamorphic loop over 
+// boxed values becomes a sequence of monomorphic loops over plain values.
+//
+// The set of types is closed: PolyCollection<Show, int, Foo> accepts 
+// only ints and Foos (and requires them to be instances of Show).
+
+template<class T>
+struct Show {
+    static std::string show(T const &) = delete;
+};
+
+// Show int
+template<>
+TC_INSTANCE(Show<int>, {
+    static std::string show(int const & x) {
+        return ("int"+std::to_string(x));
+    }
+});
+
+struct Foo{};
+
+// Show Foo
+template<>
+TC_INSTANCE(Show<Foo>, {
+    static std::string show(Foo const & x) {
+        return "Foo";
+    }
+});
+
+struct Bar{ int x; };
+
+// Show Bar
+template<>
+TC_INSTANCE(Show<Bar>, {
+    static std::string show(Bar const & x) {
+        return "Bar" + std::to_string(x.x);
+    }
+});
+
+
+// print Show instances
+template<class T>
+std::ostream & operator<<(std::ostream & os, T const & x) {
+    // we are using std::operator<< explicitly to avoid ambigous overload
+    std::operator<<(os,tc_impl_t<Show<T>>::show(x));
+    return os;
+}
+
+
+// the position of T in Ts...
+template<class T, class... Ts> struct IndexOf;
+
+template<class T, class... Ts> 
+struct IndexOf<T, T, Ts...> { static constexpr std::size_t value = 0; };
+
+template<class T, class U, class... Ts> 
+struct IndexOf<T, U, Ts...> { 
+    static constexpr std::size_t value = 1 + IndexOf<T, Ts...>::value; 
+};
+
+
+template<template<class> class TC, class... Ts>
+class PolyCollection {
+    // constrained definition: all the types must implement TC
+    // (a variadic analogue of TC_REQUIRE)
+    static_assert( sizeof(std::tuple<_tc_dummy_<tc_impl_t<TC<Ts>>>...>), 
+                   "unreachable" );
+
+    std::tuple<std::vector<Ts>...> segments;
+
+    template<class F, std::size_t... I>
+    void for_each_segment_impl(F & f, std::index_sequence<I...>) const {
+        (void)std::initializer_list<int>{ (f(std::get<I>(segments)), 0)... };
+    }
+
+public:
+    template<class T>
+    std::vector<T> & segment() {
+        return std::get<IndexOf<T, Ts...>::value>(segments);
+    }
+
+    template<class T>
+    std::vector<T> const & segment() const {
+        return std::get<IndexOf<T, Ts...>::value>(segments);
+    }
+
+    template<class T>
+    void insert(T const & x) {
+        segment<T>().push_back(x);
+    }
+
+    template<class T, class... Args>
+    void emplace(Args && ... args) {
+        segment<T>().emplace_back(std::forward<Args>(args)...);
+    }
+
+    std::size_t size() const {
+        std::size_t n = 0;
+        for_each_segment([&](auto const & seg) { n += seg.size(); });
+        return n;
+    }
+
+    // f is called with every segment (std::vector<T> const &)
+    template<class F>
+    void for_each_segment(F f) const {
+        for_each_segment_impl(f, std::index_sequence_for<Ts...>());
+    }
+
+    // f is called with every element (a generic lambda is instantiated
+    // once per segment type, so the calls are static)
+    template<class F>
+    void for_each(F f) const {
+        for_each_segment([&](auto const & seg) {
+            for (auto const & x : seg) f(x);
+        });
+    }
+};
+
+
+// Show a collection segment by segment.
+template<class... Ts>
+TC_INSTANCE(TC(Show<PolyCollection<Show, Ts...>>), {
+    static std::string show(PolyCollection<Show, Ts...> const & xs) {
+        std::string res = "[";
+        bool first = true;
+
+        xs.for_each([&](auto const & x) {
+            typedef typename std::decay<decltype(x)>::type T;
+
+            if (!first) res += ",";
+            first = false;
+
+            res += tc_impl_t<Show<T>>::show(x); // a static call
+        });
+
+        res += "]";
+
+        return res;
+    }
+});
+
+
+int main() {
+    PolyCollection<Show, int, Foo, Bar> some_showables;
+
+    some_showables.insert(1);
+    some_showables.insert(Foo());
+    some_showables.insert(2);
+    some_showables.emplace<Bar>(Bar{3});
+    // some_showables.insert(1.0); // won't compile: double is not a segment
+
+    // elements are grouped by their types
+    std::cout << some_showables << std::endl;
+    std::cout << some_showables.size() << std::endl;
+
+    // PolyCollection<Show, int, double> bad; // won't compile: no Show double
+
+    // a monomorphic loop over a single segment
+    int sum = 0;
+    for (int x : some_showables.segment<int>()) sum += x;
+    std::cout << sum << std::endl;
+}
@@ -0,0 +1,134 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <memory_resource>
+#include <cstdint>
+#include <cstdlib>
+#include <cstddef>
+#include <new>
+#include <assert.h>
+#include "../tc_dyn.hpp"
+#include "show_arena.hpp"
+#include "allocs.hpp" // allocations are counted to show the difference with to_dyn
+
+// Existentials of show_dyn.cpp allocated in bulk (C++17): the values
+// are placed in a monotonic arena (a std::pmr::memory_resource or any
+// class with an allocate(bytes, alignment) method) and the handles
+// (tc_dyn_in) only destroy them. The memory is released all at once
+// together with the arena. The arena and the batch are in show_arena.hpp.
+
+
+template<class T>
+struct Show {
+    static std::string show(T const &) = delete;
+};
+
+template<>
+TC_INSTANCE(Show<int>, {
+    static std::string show(int const & x) {
+        return ("int"+std::to_string(x));
+    }
+});
+
+struct Foo{};
+
+template<>
+TC_INSTANCE(Show<Foo>, {
+    static std::string show(Foo const &) {
+        return "Foo";
+    }
+});
+
+// a value with a non-trivial destructor
+struct Name {
+    static int alive;
+    std::string s;
+
+    Name(std::string s): s(std::move(s)) { alive++; }
+    Name(Name && other): s(std::move(other.s)) { alive++; }
+    ~Name() { alive--; }
+};
+
+int Name::alive = 0;
+
+template<>
+TC_INSTANCE(Show<Name>, {
+    static std::string show(Name const & x) {
+        return x.s;
+    }
+});
+
+#define SHOW_METHODS(m) \
+    m(show, std::string())
+
+TC_DYN(Show, SHOW_METHODS)
+
+
+// a to_show-style constructor for a resource
+template<class Resource, class T>
+tc_dyn_in<Show> to_show(Resource & resource, T && x) {
+    return to_dyn_in<Show>(resource, std::forward<T>(x));
+}
+
+
+// Show a => Show (batch a)
+template<class Resource>
+TC_INSTANCE(TC(Show<DynBatch<Show, Resource>>), {
+    static std::string show(DynBatch<Show, Resource> const & xs) {
+        TC_IMPL(Show<tc_dyn_in<Show>>) S;
+        std::string res = "[";
+        for (std::size_t i = 0; i < xs.size(); i++) {
+            if (i > 0) res += ",";
+            res += S::show(xs[i]);
+        }
+        return res + "]";
+    }
+});
+
+
+int main() {
+    TC_IMPL(Show<tc_dyn_in<Show>>) S;
+    std::size_t const n = 1000;
+
+    // a batch over std::pmr::monotonic_buffer_resource
+    {
+        DynBatch<Show> batch;
+        batch.reserve(3);
+        batch.push(1);
+        batch.push(Foo());
+        batch.emplace<Name>("name");
+        assert(Name::alive == 1);
+
+        std::cout << tc_impl_t<Show<DynBatch<Show>>>::show(batch) << std::endl;
+    }
+    assert(Name::alive == 0); // the destructor has been run
+
+    // n values: one allocation per value with to_dyn...
+    std::size_t before = allocs;
+    {
+        std::vector<tc_dyn<Show>> heap;
+        heap.reserve(n);
+        for (std::size_t i = 0; i < n; i++) heap.push_back(to_dyn<Show>(int(i)));
+    }
+    std::size_t heap_allocs = allocs - before;
+
+    // ...and a few chunks with an arena
+    before = allocs;
+    {
+        DynBatch<Show, Arena> batch;
+        batch.reserve(n);
+        for (std::size_t i = 0; i < n; i++) batch.push(int(i));
+        assert(S::show(batch[n - 1]) == "int999");
+    }
+    std::size_t arena_allocs = allocs - before;
+
+    std::cout << heap_allocs << " allocations vs " << arena_allocs << std::endl;
+    assert(heap_allocs > n && arena_allocs < 10);
+
+    // handles for values in a caller-owned resource
+    std::pmr::monotonic_buffer_resource pool;
+    std::vector<tc_dyn_in<Show>> xs;
+    xs.push_back(to_show(pool, 2));
+    xs.push_back(to_show(pool, Name("two")));
+    for (auto const & x: xs) std::cout << S::show(x) << std::endl;
+}
@@ -0,0 +1,92 @@
+// Existentials allocated in bulk (tc_dyn_in of tc_dyn.hpp, C++17): a
+// minimal monotonic arena and a batch of existentials owning its arena,
+// shared by show_arena.cpp and bench/dyn_arena.cpp.
+
+#ifndef _SHOW_ARENA_HPP_
+#define _SHOW_ARENA_HPP_
+
+#include <vector>
+#include <memory_resource>
+#include <algorithm>
+#include <utility>
+#include <cstdint>
+#include <cstddef>
+#include <new>
+#include "../tc_dyn.hpp"
+
+// A minimal monotonic arena (no pmr needed): memory is taken in
+// growing chunks and released only by the destructor.
+class Arena {
+    struct Chunk { Chunk * next; };
+
+    Chunk * chunks = nullptr;
+    char * cur = nullptr;
+    char * end = nullptr;
+    std::size_t chunk_size;
+
+    void grow(std::size_t n) {
+        std::size_t size = std::max(chunk_size, n) + sizeof(std::max_align_t);
+        Chunk * c = static_cast<Chunk *>(::operator new(size));
+
+        c->next = chunks;
+        chunks = c;
+        cur = reinterpret_cast<char *>(c) + sizeof(std::max_align_t);
+        end = reinterpret_cast<char *>(c) + size;
+        chunk_size *= 2;
+    }
+
+public:
+    explicit Arena(std::size_t chunk_size = 1 << 12): chunk_size(chunk_size) {}
+    Arena(Arena const &) = delete;
+
+    ~Arena() {
+        while (chunks) {
+            Chunk * next = chunks->next;
+            ::operator delete(chunks);
+            chunks = next;
+        }
+    }
+
+    void * allocate(std::size_t n, std::size_t align) {
+        std::uintptr_t p = (std::uintptr_t(cur) + align - 1) & ~std::uintptr_t(align - 1);
+        if (!cur || p + n > std::uintptr_t(end)) {
+            grow(n + align);
+            p = (std::uintptr_t(cur) + align - 1) & ~std::uintptr_t(align - 1);
+        }
+        cur = reinterpret_cast<char *>(p + n);
+        return reinterpret_cast<void *>(p);
+    }
+};
+
+
+// A batch of existentials owning its arena: the handles are destroyed
+// first (only the values with non-trivial destructors do something),
+// then the arena releases the memory in a few blocks.
+template<template<class> class TC, class Resource = std::pmr::monotonic_buffer_resource>
+class DynBatch {
+    Resource resource; // declared first, so destroyed last
+    std::vector<tc_dyn_in<TC>> items;
+
+public:
+    template<class... Args>
+    explicit DynBatch(Args && ... args): resource(std::forward<Args>(args)...) {}
+
+    template<class T>
+    void push(T && x) {
+        items.push_back(to_dyn_in<TC>(resource, std::forward<T>(x)));
+    }
+
+    template<class T, class... Args>
+    void emplace(Args && ... args) {
+        items.push_back(tc_dyn_in<TC>::template make<T>(resource, std::forward<Args>(args)...));
+    }
+
+    void reserve(std::size_t n) { items.reserve(n); }
+    std::size_t size() const { return items.size(); }
+
+    tc_dyn_in<TC> const & operator[](std::size_t i) const { return items[i]; }
+    auto begin() const { return items.begin(); }
+    auto end() const { return items.end(); }
+};
+
+#endif // _SHOW_ARENA_HPP_
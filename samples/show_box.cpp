@@ -0,0 +1,299 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <memory>
+#include <new>
+#include <utility>
+#include <cstddef>
+#include <assert.h>
+#include <type_traits>
+#include "../tc.hpp"
+
+// An owning existential box with inline storage (a small buffer 
+// optimization of to_show from show.cpp).
+//
+// Small nothrow-movable values live inside the box, other ones 
+// spill to the heap (and only the pointer moves with the box). 
+// Values are constructed in place.
+
+template<class T>
+struct Show {
+    static std::string show(T const &) = delete;
+};
+
+// Show int
+template<>
+TC_INSTANCE(Show<int>, {
+    static std::string show(int const & x) {
+        return ("int"+std::to_string(x));
+    }
+});
+
+struct Foo{};
+
+// Show Foo
+template<>
+TC_INSTANCE(Show<Foo>, {
+    static std::string show(Foo const & x) {
+        return "Foo";
+    }
+});
+
+// a value too large for the default inline storage
+struct Big { char data[256]; };
+
+template<>
+TC_INSTANCE(Show<Big>, {
+    static std::string show(Big const & x) {
+        return "Big";
+    }
+});
+
+// a value which can't be moved at all
+struct Pinned { 
+    char data[256];
+
+    Pinned() {}
+    Pinned(Pinned &&) = delete;
+};
+
+template<>
+TC_INSTANCE(Show<Pinned>, {
+    static std::string show(Pinned const & x) {
+        return "Pinned";
+    }
+});
+
+
+// Show a => Show [a]
+template<class T>
+TC_INSTANCE(Show<std::vector<T>>, {
+    static std::string show(std::vector<T> const & xs) {
+        std::string res = "[";
+
+        if (xs.size() > 0) {
+            for (size_t i = 0; i < xs.size() - 1; i++) {
+                res += tc_impl_t<Show<T>>::show(xs[i]);
+                res += ",";
+            }
+
+            res += tc_impl_t<Show<T>>::show(xs[xs.size()-1]);
+        }
+
+        res += "]";
+
+        return res;
+    }
+});
+
+
+// print Show instances
+template<class T>
+std::ostream & operator<<(std::ostream & os, T const & x) {
+    // we are using std::operator<< explicitly to avoid ambigous overload
+    std::operator<<(os,tc_impl_t<Show<T>>::show(x));
+    return os;
+}
+
+
+// The DynShow of show.cpp with one more method: a box must be able 
+// to move its content without knowing its type.
+struct DynShow {
+    virtual std::string show_me() const = 0;
+    virtual DynShow * move_to(void * storage) noexcept = 0;
+    virtual ~DynShow() {}
+};
+
+template<>
+TC_INSTANCE(Show<DynShow>, {
+    static std::string show(DynShow const & x) {
+        return x.show_me();
+    }
+});
+
+
+// an inline (hence nothrow-movable) value
+template<class T>
+struct DynShowWrapper: DynShow {
+    T self;
+
+    std::string show_me() const {
+        return tc_impl_t<Show<T>>::show(self);
+    }
+
+    DynShow * move_to(void * storage) noexcept {
+        return ::new (storage) DynShowWrapper(std::move(*this));
+    }
+
+    // in-place construction instead of DynShowWrapper(T x): self(x)
+    template<class... Args>
+    explicit DynShowWrapper(Args && ... args)
+        : self(std::forward<Args>(args)...) {}
+};
+
+// a value on the heap: the wrapper itself is inline and moves 
+// the pointer, T doesn't need to be movable
+template<class T>
+struct DynShowHeapWrapper: DynShow {
+    std::unique_ptr<T> self;
+
+    std::string show_me() const {
+        return tc_impl_t<Show<T>>::show(*self);
+    }
+
+    DynShow * move_to(void * storage) noexcept {
+        return ::new (storage) DynShowHeapWrapper(std::move(*this));
+    }
+
+    template<class... Args>
+    explicit DynShowHeapWrapper(Args && ... args)
+        : self(new T(std::forward<Args>(args)...)) {}
+
+    DynShowHeapWrapper(DynShowHeapWrapper &&) noexcept = default;
+};
+
+
+// N is the size of the inline storage in bytes 
+// (by default a wrapped value of two pointers fits inline).
+//
+// The storage always holds a wrapper: of the value itself or of 
+// a pointer to it (DynShowHeapWrapper).
+template<std::size_t N = 3 * sizeof(void *)>
+class ShowBox {
+    static_assert(N >= sizeof(DynShowHeapWrapper<int>), 
+                  "the inline storage must hold at least a pointer wrapper");
+
+    typename std::aligned_storage<N, alignof(std::max_align_t)>::type buf;
+    DynShow * ptr;
+    bool heap;
+
+    void reset() {
+        if (ptr) ptr->~DynShow();
+        ptr = nullptr;
+    }
+
+    // moves the content of other (emptied) into an empty box
+    void take(ShowBox & other) noexcept {
+        if (other.ptr) {
+            ptr = other.ptr->move_to(&buf);
+            heap = other.heap;
+            other.reset();
+        }
+    }
+
+    ShowBox(): ptr(nullptr), heap(false) {}
+
+    template<class T, class... Args>
+    void emplace(std::true_type /* inline */, Args && ... args) {
+        ptr = ::new ((void *)&buf) DynShowWrapper<T>(std::forward<Args>(args)...);
+    }
+
+    template<class T, class... Args>
+    void emplace(std::false_type /* inline */, Args && ... args) {
+        ptr = ::new ((void *)&buf) DynShowHeapWrapper<T>(std::forward<Args>(args)...);
+        heap = true;
+    }
+
+public:
+    template<class T>
+    static constexpr bool fits_inline() {
+        return sizeof(DynShowWrapper<T>) <= N
+            && alignof(DynShowWrapper<T>) <= alignof(std::max_align_t)
+            && std::is_nothrow_move_constructible<T>::value;
+    }
+
+    // in-place constructor: make<T>(constructor arguments of T)
+    template<class T, class... Args>
+    static ShowBox make(Args && ... args) {
+        ShowBox box;
+        box.template emplace<T>(
+            std::integral_constant<bool, fits_inline<T>()>(),
+            std::forward<Args>(args)...);
+        return box;
+    }
+
+    ShowBox(ShowBox && other) noexcept: ptr(nullptr), heap(false) {
+        take(other);
+    }
+
+    ShowBox & operator=(ShowBox && other) noexcept {
+        if (this != &other) {
+            reset();
+            take(other);
+        }
+        return *this;
+    }
+
+    ShowBox(ShowBox const &) = delete;
+    ShowBox & operator=(ShowBox const &) = delete;
+
+    ~ShowBox() { reset(); }
+
+    bool is_inline() const { return ptr && !heap; }
+
+    DynShow const & operator*() const { return *ptr; }
+};
+
+// type-inferring constructor
+template<class T, std::size_t N = 3 * sizeof(void *)>
+ShowBox<N> to_show_box(T && x) {
+    return ShowBox<N>::template make<typename std::decay<T>::type>(
+        std::forward<T>(x));
+}
+
+// a boxed value is showable
+template<std::size_t N>
+TC_INSTANCE(Show<ShowBox<N>>, {
+    static std::string show(ShowBox<N> const & box) {
+        return tc_impl_t<Show<DynShow>>::show(*box);
+    }
+});
+
+// the forwarding instance from show.cpp
+template<class T>
+TC_INSTANCE(Show<std::unique_ptr<T>>, {
+    static std::string show(std::unique_ptr<T> const & ptr) {
+        return tc_impl_t<Show<T>>::show(*ptr);
+    }
+});
+
+
+int main() {
+    auto small = to_show_box(3);
+    auto large = to_show_box(Big());
+    auto boxed = to_show_box(std::make_unique<Foo>());
+
+    assert(small.is_inline());
+    assert(!large.is_inline());
+    assert(boxed.is_inline()); // a unique_ptr is small and nothrow-movable
+
+    std::cout << small << std::endl;
+    std::cout << large << std::endl;
+    std::cout << boxed << std::endl;
+
+    // in-place construction of a vector with 3 elements equal to 7
+    auto vec = ShowBox<>::make<std::vector<int>>(3, 7);
+    std::cout << vec << std::endl;
+
+    // a larger inline storage
+    auto big_inline = ShowBox<512>::make<Big>();
+    assert(big_inline.is_inline());
+    std::cout << big_inline << std::endl;
+
+    // an analogue of Vec<Box<dyn Show>> from show.cpp
+    std::vector<ShowBox<>> some_showables;
+
+    some_showables.push_back(to_show_box(1));
+    some_showables.push_back(to_show_box(Foo()));
+    some_showables.push_back(to_show_box(2));
+    some_showables.push_back(std::move(large));
+
+    std::cout << some_showables << std::endl;
+
+    // a value which can't be moved stays on the heap, its box moves
+    auto pinned = ShowBox<>::make<Pinned>();
+    assert(!pinned.is_inline());
+    auto moved = std::move(pinned);
+    pinned = std::move(moved);
+    std::cout << pinned << std::endl;
+}
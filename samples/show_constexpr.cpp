@@ -0,0 +1,341 @@
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <array>
+#include <utility>
+#include <cstdlib>
+#include <new>
+#include <type_traits>
+#include <assert.h>
+#include "../tc.hpp"
+#include "allocs.hpp" // allocations are counted to show that show_sv doesn't allocate
+
+// Typeclass methods evaluated at compile time (C++17).
+//
+// Nothing in tc.hpp prevents instance methods from being constexpr:
+// tc_impl_t<C<T>> is an ordinary struct with static methods.
+//
+// Show here writes into a caller-provided buffer, so it can run in
+// a constant expression. The text of a constant value (static_show)
+// and of every value of a small enumerable type (show_sv) is rendered
+// at compile time into static storage, so showing it allocates nothing.
+
+
+template<class T>
+struct Eq {
+    static constexpr bool equal(T const & a, T const & b) = delete;
+};
+
+template<class T>
+struct Show {
+    // the length of the text
+    static constexpr std::size_t size(T const & x) = delete;
+
+    // writes size(x) chars to out, returns the end
+    static constexpr char * write(char * out, T const & x) = delete;
+
+    static std::string show(T const & x) {
+        TC_IMPL(Show<T>) ShowT;
+        std::string res(ShowT::size(x), '\0');
+        ShowT::write(&res[0], x);
+        return res;
+    }
+};
+
+// the values first() ... last() can be pre-rendered
+template<class T>
+struct Enumerable {
+    static constexpr T first() = delete;
+    static constexpr T last() = delete;
+};
+
+template<class T>
+using HasInstance = std::integral_constant<bool, tc_has_instance<T>::value>;
+
+
+constexpr char * write_str(char * out, std::string_view s) {
+    for (char c: s) *out++ = c;
+    return out;
+}
+
+
+// int
+
+template<>
+TC_INSTANCE(Eq<int>, {
+    static constexpr bool equal(int const & a, int const & b) {
+        return a == b;
+    }
+});
+
+template<>
+TC_INSTANCE(Show<int>, {
+    static constexpr std::size_t size(int const & x) {
+        std::size_t n = x < 0 ? 2 : 1;
+        for (unsigned u = x < 0 ? 0u - unsigned(x) : unsigned(x); u >= 10; u /= 10) n++;
+        return n;
+    }
+
+    static constexpr char * write(char * out, int const & x) {
+        char * end = out + size(x);
+        char * p = end;
+        unsigned u = x < 0 ? 0u - unsigned(x) : unsigned(x);
+        do { *--p = char('0' + u % 10); u /= 10; } while (u);
+        if (x < 0) *--p = '-';
+        return end;
+    }
+});
+
+
+// bool
+
+template<>
+TC_INSTANCE(Show<bool>, {
+    static constexpr std::size_t size(bool const & x) {
+        return x ? 4 : 5;
+    }
+
+    static constexpr char * write(char * out, bool const & x) {
+        return write_str(out, x ? "true" : "false");
+    }
+});
+
+template<>
+TC_INSTANCE(Enumerable<bool>, {
+    static constexpr bool first() { return false; }
+    static constexpr bool last() { return true; }
+});
+
+
+// an enum
+
+enum class Color { Red, Green, Blue };
+
+template<>
+TC_INSTANCE(Show<Color>, {
+    static constexpr std::string_view name(Color c) {
+        switch (c) {
+            case Color::Red: return "Red";
+            case Color::Green: return "Green";
+            case Color::Blue: return "Blue";
+        }
+        return "Color?";
+    }
+
+    static constexpr std::size_t size(Color const & c) {
+        return name(c).size();
+    }
+
+    static constexpr char * write(char * out, Color const & c) {
+        return write_str(out, name(c));
+    }
+});
+
+template<>
+TC_INSTANCE(Enumerable<Color>, {
+    static constexpr Color first() { return Color::Red; }
+    static constexpr Color last() { return Color::Blue; }
+});
+
+
+// a tag (cf. Foo in show.cpp): a type with a single value
+
+struct Foo {};
+
+template<>
+TC_INSTANCE(Show<Foo>, {
+    static constexpr std::size_t size(Foo const &) { return 3; }
+    static constexpr char * write(char * out, Foo const &) {
+        return write_str(out, "Foo");
+    }
+});
+
+
+// pairs
+
+template<class A, class B>
+TC_INSTANCE(TC(Eq<std::pair<A, B>>), {
+    static constexpr bool equal(std::pair<A, B> const & a, std::pair<A, B> const & b) {
+        return tc_impl_t<Eq<A>>::equal(a.first, b.first)
+            && tc_impl_t<Eq<B>>::equal(a.second, b.second);
+    }
+});
+
+template<class A, class B>
+TC_INSTANCE(TC(Show<std::pair<A, B>>), {
+    static constexpr std::size_t size(std::pair<A, B> const & x) {
+        return tc_impl_t<Show<A>>::size(x.first) + tc_impl_t<Show<B>>::size(x.second) + 4;
+    }
+
+    static constexpr char * write(char * out, std::pair<A, B> const & x) {
+        out = write_str(out, "(");
+        out = tc_impl_t<Show<A>>::write(out, x.first);
+        out = write_str(out, ", ");
+        out = tc_impl_t<Show<B>>::write(out, x.second);
+        return write_str(out, ")");
+    }
+});
+
+
+// arrays
+
+template<class T, std::size_t N>
+TC_INSTANCE(TC(Eq<std::array<T, N>>), {
+    static constexpr bool equal(std::array<T, N> const & a, std::array<T, N> const & b) {
+        for (std::size_t i = 0; i < N; i++) {
+            if (!tc_impl_t<Eq<T>>::equal(a[i], b[i])) return false;
+        }
+        return true;
+    }
+});
+
+// T has the kind * -> * (cf. functor.cpp)
+template<template<class> class T>
+struct Functor {
+    template<class A, class F>
+    static constexpr auto fmap(T<A> const & xs, F f) -> T<decltype(f(std::declval<A>()))>
+    = delete;
+};
+
+// std::array has a non-type parameter, so it is a functor
+// only with a fixed size (cf. Vec in functor.cpp)
+template<class T> using Array3 = std::array<T, 3>;
+
+template<>
+TC_INSTANCE(Functor<Array3>, {
+    template<class A, class F>
+    static constexpr auto fmap(Array3<A> const & xs, F f) -> Array3<decltype(f(std::declval<A>()))> {
+        Array3<decltype(f(std::declval<A>()))> res{};
+        for (std::size_t i = 0; i < xs.size(); i++) res[i] = f(xs[i]);
+        return res;
+    }
+});
+
+
+// ----------------------- compile-time rendering ----------------------- //
+
+// The text of C::value rendered at compile time.
+template<class C>
+struct _static_text_ {
+    typedef typename std::remove_cv<decltype(C::value)>::type T;
+
+    static constexpr std::size_t size = tc_impl_t<Show<T>>::size(C::value);
+
+    static constexpr std::array<char, size + 1> text = [] {
+        std::array<char, size + 1> buf{};
+        tc_impl_t<Show<T>>::write(buf.data(), C::value);
+        return buf;
+    }();
+
+    static constexpr std::string_view view() { return { text.data(), size }; }
+};
+
+// the text of a constant: static_show<42>(), static_show<Color::Red>()
+template<auto V>
+constexpr std::string_view static_show() {
+    return _static_text_<std::integral_constant<decltype(V), V>>::view();
+}
+
+template<class T, long long I>
+struct _enum_value_ {
+    static constexpr T value = T(static_cast<long long>(tc_impl_t<Enumerable<T>>::first()) + I);
+};
+
+template<class T, std::size_t... I>
+constexpr std::array<std::string_view, sizeof...(I)> _prerender_(std::index_sequence<I...>) {
+    return {{ _static_text_<_enum_value_<T, (long long)I>>::view()... }};
+}
+
+// the texts of all the values of an Enumerable type
+template<class T>
+struct _prerendered_ {
+    TC_IMPL(Enumerable<T>) E;
+
+    static constexpr long long first = static_cast<long long>(E::first());
+    static constexpr std::size_t count = std::size_t(static_cast<long long>(E::last()) - first + 1);
+    static constexpr auto table = _prerender_<T>(std::make_index_sequence<count>());
+};
+
+template<class T>
+struct _tag_ { static constexpr T value{}; };
+
+// Show without allocation: a string_view into a text rendered at
+// compile time, for Enumerable types ("?" for a value out of the range 
+// first()..last(), e.g. a cast integer)...
+template<class T, std::enable_if_t<HasInstance<Enumerable<T>>::value, int> = 0>
+constexpr std::string_view show_sv(T const & x) {
+    long long i = static_cast<long long>(x) - _prerendered_<T>::first;
+    if (i < 0 || std::size_t(i) >= _prerendered_<T>::count) return "?";
+    return _prerendered_<T>::table[std::size_t(i)];
+}
+
+// ...and for tags (empty types have a single value)
+template<class T, std::enable_if_t<std::is_empty<T>::value, int> = 0>
+constexpr std::string_view show_sv(T const &) {
+    return _static_text_<_tag_<T>>::view();
+}
+
+
+// a check that a value is shown as s, usable in constant expressions
+template<class T>
+constexpr bool shows_as(T const & x, std::string_view s) {
+    char buf[64] = {};
+    TC_IMPL(Show<T>) ShowT;
+    if (ShowT::size(x) != s.size()) return false;
+    ShowT::write(buf, x);
+    return std::string_view(buf, s.size()) == s;
+}
+
+
+// a fixed-size log line: appending does no allocation
+struct LogLine {
+    std::array<char, 128> buf;
+    std::size_t len = 0;
+
+    LogLine & operator<<(std::string_view s) {
+        std::size_t n = std::min(s.size(), buf.size() - len);
+        for (std::size_t i = 0; i < n; i++) buf[len++] = s[i];
+        return *this;
+    }
+
+    std::string_view view() const { return { buf.data(), len }; }
+};
+
+
+int main() {
+    // the instances in constant expressions
+    static_assert(tc_impl_t<Eq<std::pair<int, int>>>::equal({1, 2}, {1, 2}));
+
+    constexpr Array3<int> xs = {1, 2, 3};
+    constexpr auto sq = tc_impl_t<Functor<Array3>>::fmap(xs, [](int x) { return x * x; });
+    static_assert(tc_impl_t<Eq<Array3<int>>>::equal(sq, {1, 4, 9}));
+
+    static_assert(shows_as(std::make_pair(-12, Color::Green), "(-12, Green)"));
+    static_assert(shows_as(std::make_pair(true, Foo{}), "(true, Foo)"));
+
+    // constants rendered at compile time
+    static_assert(static_show<42>() == "42");
+    static_assert(static_show<-2147483647 - 1>() == "-2147483648");
+    static_assert(static_show<Color::Blue>() == "Blue");
+    static_assert(show_sv(Color::Green) == "Green");
+    static_assert(show_sv(Foo{}) == "Foo");
+    static_assert(show_sv(Color(42)) == "?");
+
+    // the same string_view every time: no allocation
+    assert(show_sv(Color::Red).data() == show_sv(Color::Red).data());
+
+    Color const colors[] = { Color::Red, Color::Green, Color::Blue };
+    std::size_t before = allocs;
+
+    LogLine line;
+    for (int i = 0; i < 3; i++) {
+        line << show_sv(colors[i]) << " " << show_sv(i % 2 == 0) << "; ";
+    }
+    line << show_sv(Foo{}) << " " << static_show<404>();
+
+    assert(allocs == before);
+    assert(line.view() == "Red true; Green false; Blue true; Foo 404");
+
+    std::cout << line.view() << std::endl;
+    std::cout << tc_impl_t<Show<std::pair<int, Color>>>::show({7, Color::Blue}) << std::endl;
+}
@@ -0,0 +1,122 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <memory>
+#include "../tc_dyn.hpp"
+
+// The existentials of show.cpp generated by TC_DYN (see tc_dyn.hpp): 
+// no DynShow, no DynShowWrapper, no virtual calls.
+
+template<class T>
+struct Show {
+    static std::string show(T const &) = delete;
+};
+
+// Show int
+template<>
+TC_INSTANCE(Show<int>, {
+    static std::string show(int const & x) {
+        return ("int"+std::to_string(x));
+    }
+});
+
+struct Foo{};
+
+// Show Foo
+template<>
+TC_INSTANCE(Show<Foo>, {
+    static std::string show(Foo const & x) {
+        return "Foo";
+    }
+});
+
+
+// Show a => Show [a]
+template<class T>
+TC_INSTANCE(Show<std::vector<T>>, {
+    static std::string show(std::vector<T> const & xs) {
+        std::string res = "[";
+
+        if (xs.size() > 0) {
+            for (size_t i = 0; i < xs.size() - 1; i++) {
+                res += tc_impl_t<Show<T>>::show(xs[i]);
+                res += ",";
+            }
+
+            res += tc_impl_t<Show<T>>::show(xs[xs.size()-1]);
+        }
+
+        res += "]";
+
+        return res;
+    }
+});
+
+
+// print Show instances
+template<class T>
+std::ostream & operator<<(std::ostream & os, T const & x) {
+    // we are using std::operator<< explicitly to avoid ambigous overload
+    std::operator<<(os,tc_impl_t<Show<T>>::show(x));
+    return os;
+}
+
+
+// dyn Show: the methods are listed once
+#define SHOW_METHODS(m) \
+    m(show, std::string())
+
+TC_DYN(Show, SHOW_METHODS)
+
+
+// A typeclass with several methods and extra arguments.
+template<class T>
+struct Scale {
+    static double scale(T const & x, double factor) = delete;
+    static bool is_zero(T const & x) = delete;
+};
+
+template<>
+TC_INSTANCE(Scale<int>, {
+    static double scale(int const & x, double factor) { return x * factor; }
+    static bool is_zero(int const & x) { return x == 0; }
+});
+
+template<>
+TC_INSTANCE(Scale<double>, {
+    static double scale(double const & x, double factor) { return x * factor; }
+    static bool is_zero(double const & x) { return x == 0.0; }
+});
+
+#define SCALE_METHODS(m) \
+    m(scale, double(double)) \
+    m(is_zero, bool())
+
+TC_DYN(Scale, SCALE_METHODS)
+
+
+int main() {
+    std::cout << to_dyn<Show>(3) << std::endl;
+
+    // an analogue of rusty Vec<Box<dyn Show>>
+    std::vector<tc_dyn<Show>> some_showables;
+
+    some_showables.push_back(to_dyn<Show>(1));
+    some_showables.push_back(to_dyn<Show>(Foo()));
+    some_showables.push_back(tc_dyn<Show>::make<std::vector<int>>(2, 5));
+
+    std::cout << some_showables << std::endl;
+
+    std::vector<tc_dyn<Scale>> scalables;
+
+    scalables.push_back(to_dyn<Scale>(2));
+    scalables.push_back(to_dyn<Scale>(0.25));
+    scalables.push_back(to_dyn<Scale>(0));
+
+    TC_IMPL(Scale<tc_dyn<Scale>>) S;
+
+    for (auto const & x : scalables) {
+        std::cout << S::scale(x, 10) << std::endl;
+        std::cout << std::boolalpha << S::is_zero(x) << std::endl;
+    }
+}
@@ -0,0 +1,161 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <cstdlib>
+#include <new>
+#include <assert.h>
+#include "../tc.hpp"
+
+// Allocation-free Show: instances append their output into 
+// a caller-provided sink instead of returning fresh strings.
+//
+// The show and show_to methods are defined in terms of each other
+// (cf. default.cpp), so an instance may define either of them.
+// The show_size method is a hint allowing to reserve the output once.
+
+template<class T>
+struct Show {
+    // A Sink is anything with an append(char const *, std::size_t) method 
+    // (e.g. std::string).
+    template<class Sink>
+    static void show_to(Sink & sink, T const & x) {
+        TC_IMPL(Show<T>) ShowT;
+        std::string s = ShowT::show(x);
+        sink.append(s.data(), s.size());
+    }
+
+    static std::string show(T const & x) {
+        TC_IMPL(Show<T>) ShowT;
+        std::string res;
+        res.reserve(ShowT::show_size(x));
+        ShowT::show_to(res, x);
+        return res;
+    }
+
+    // the length of the output, exact or an upper bound (0 if unknown)
+    static std::size_t show_size(T const &) {
+        return 0;
+    }
+};
+
+// Show int: defines the sink-based method
+template<>
+TC_INSTANCE(Show<int>, {
+    template<class Sink>
+    static void show_to(Sink & sink, int const & x) {
+        char buf[16];
+        char * end = buf + sizeof(buf);
+        char * p = end;
+        unsigned u = x < 0 ? 0u - unsigned(x) : unsigned(x);
+
+        do { *--p = char('0' + u % 10); u /= 10; } while (u);
+        if (x < 0) *--p = '-';
+
+        sink.append("int", 3);
+        sink.append(p, std::size_t(end - p));
+    }
+
+    static std::size_t show_size(int const & x) {
+        std::size_t n = x < 0 ? 5 : 4; // "int", a sign and a digit
+        for (unsigned u = x < 0 ? 0u - unsigned(x) : unsigned(x); u >= 10; u /= 10) n++;
+        return n;
+    }
+});
+
+struct Foo{};
+
+// Show Foo: defines only the old string-returning method
+template<>
+TC_INSTANCE(Show<Foo>, {
+    static std::string show(Foo const & x) {
+        return "Foo";
+    }
+});
+
+
+// Show a => Show [a]
+template<class T>
+TC_INSTANCE(Show<std::vector<T>>, {
+    template<class Sink>
+    static void show_to(Sink & sink, std::vector<T> const & xs) {
+        sink.append("[", 1);
+
+        for (size_t i = 0; i < xs.size(); i++) {
+            if (i > 0) sink.append(",", 1);
+            tc_impl_t<Show<T>>::show_to(sink, xs[i]);
+        }
+
+        sink.append("]", 1);
+    }
+
+    static std::size_t show_size(std::vector<T> const & xs) {
+        std::size_t n = xs.size() > 0 ? xs.size() + 1 : 2; // brackets and commas
+        for (auto const & x : xs) {
+            std::size_t m = tc_impl_t<Show<T>>::show_size(x);
+            if (m == 0) return 0; // unknown for an element: unknown for all
+            n += m;
+        }
+        return n;
+    }
+});
+
+
+// print Show instances
+template<class T>
+std::ostream & operator<<(std::ostream & os, T const & x) {
+    // we are using std::operator<< explicitly to avoid ambigous overload
+    std::operator<<(os,tc_impl_t<Show<T>>::show(x));
+    return os;
+}
+
+
+// a sink writing directly into a stream (no intermediate strings at all)
+struct StreamSink {
+    std::ostream & os;
+
+    void append(char const * s, std::size_t n) { os.write(s, n); }
+};
+
+
+// counting allocations to check the claims above
+static std::size_t allocations = 0;
+
+void * operator new(std::size_t n) {
+    ++allocations;
+    if (void * p = std::malloc(n ? n : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void * p) noexcept { std::free(p); }
+void operator delete(void * p, std::size_t) noexcept { std::free(p); }
+
+
+int main() {
+    std::cout << -123 << std::endl;  // old int overload
+    std::cout << Foo() << std::endl;
+    std::cout << std::vector<int>{1,-2,3} << std::endl;
+
+    std::vector<std::vector<int>> xss(100, std::vector<int>{1,22,333,-4444});
+    TC_IMPL(Show<decltype(xss)>) ShowXss;
+
+    // a nested vector is shown with a single allocation
+    std::size_t before = allocations;
+    std::string s = ShowXss::show(xss);
+    assert(allocations - before == 1);
+    assert(s.size() == ShowXss::show_size(xss));
+
+    // appending to an existing buffer doesn't allocate at all
+    std::string buf;
+    buf.reserve(4096);
+    before = allocations;
+    ShowXss::show_to(buf, xss);
+    assert(allocations - before == 0);
+    assert(buf == s);
+
+    // an unknown size of an element makes the size of the vector unknown
+    assert(tc_impl_t<Show<std::vector<Foo>>>::show_size(std::vector<Foo>(3)) == 0);
+
+    StreamSink out{std::cout};
+    tc_impl_t<Show<std::vector<Foo>>>::show_to(out, std::vector<Foo>(3));
+    std::cout << std::endl;
+}
@@ -0,0 +1,125 @@
+// the profiling mode: must be enabled before including tc_dyn.hpp
+#define TC_DYN_PROFILE
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <assert.h>
+#include "../tc_dyn.hpp"
+
+// Speculative devirtualization of calls on existentials (tc_dyn.hpp):
+// a call site where one concrete type dominates guards on its table
+// and calls its instance directly, the other types go through the
+// table as usual. A tc_dyn_site counts the hits and the misses and, in
+// the profiling mode, finds the dominant type.
+
+template<class T>
+struct Show {
+    static std::string show(T const &) = delete;
+};
+
+template<class T>
+struct Area {
+    static double area(T const & x) = delete;
+    static double scaled(T const & x, double factor) = delete;
+};
+
+struct Square { double side; };
+struct Circle { double radius; };
+struct Label { std::string text; };
+
+template<>
+TC_INSTANCE(Show<Square>, {
+    static std::string show(Square const & x) {
+        return "Square " + std::to_string(int(x.side));
+    }
+});
+
+template<>
+TC_INSTANCE(Show<Circle>, {
+    static std::string show(Circle const & x) {
+        return "Circle " + std::to_string(int(x.radius));
+    }
+});
+
+template<>
+TC_INSTANCE(Show<Label>, {
+    static std::string show(Label const & x) {
+        return x.text;
+    }
+});
+
+template<>
+TC_INSTANCE(Area<Square>, {
+    static double area(Square const & x) { return x.side * x.side; }
+    static double scaled(Square const & x, double factor) { return area(x) * factor * factor; }
+});
+
+template<>
+TC_INSTANCE(Area<Circle>, {
+    static double area(Circle const & x) { return 3 * x.radius * x.radius; }
+    static double scaled(Circle const & x, double factor) { return area(x) * factor * factor; }
+});
+
+
+#define SHOW_METHODS(m) \
+    m(show, std::string())
+
+TC_DYN(Show, SHOW_METHODS)
+
+#define AREA_METHODS(m) \
+    m(area, double()) \
+    m(scaled, double(double))
+
+TC_DYN(Area, AREA_METHODS)
+
+
+int main() {
+    // mostly squares
+    std::vector<tc_dyn<Show>> shapes;
+    std::vector<tc_dyn<Area>> areas;
+    for (int i = 0; i < 100; i++) {
+        if (i % 20 == 7) {
+            shapes.push_back(to_dyn<Show>(Circle{ double(i) }));
+            areas.push_back(to_dyn<Area>(Circle{ double(i) }));
+        } else if (i % 50 == 13) {
+            shapes.push_back(to_dyn<Show>(Label{ "label" }));
+        } else {
+            shapes.push_back(to_dyn<Show>(Square{ double(i) }));
+            areas.push_back(to_dyn<Area>(Square{ double(i) }));
+        }
+    }
+
+    // 1. the profiling run: which type dominates the call site?
+    tc_dyn_site profile("show in main (Square)");
+    for (auto const & x : shapes) tc_speculate_t<Show, Square>::show(profile, x);
+    profile.report(stdout);
+
+    assert(profile.hit_count() == 93);
+    assert(profile.miss_count() == 7);
+    assert(profile.dominant()->count == 93);
+    assert(std::string(profile.dominant()->type) == "Square");
+
+    // 2. the same results as the indirect calls, with or without a site
+    for (auto const & x : shapes) {
+        typedef tc_speculate_t<Show, Square> S;
+        assert(S::show(x) == tc_impl_t<Show<tc_dyn<Show>>>::show(x));
+    }
+
+    // 3. a typeclass with several methods and extra arguments
+    tc_dyn_site area_site("scaled in main (Circle)");
+    double speculated = 0, indirect = 0;
+    for (auto const & x : areas) {
+        speculated += tc_speculate_t<Area, Circle>::scaled(area_site, x, 2.0);
+        indirect += tc_impl_t<Area<tc_dyn<Area>>>::scaled(x, 2.0);
+    }
+    area_site.report(stdout);
+
+    assert(speculated == indirect);
+    assert(area_site.hit_count() == 5);
+    assert(area_site.miss_count() == 93);
+    // the wrong guess: the profile tells what to speculate on
+    assert(std::string(area_site.dominant()->type) == "Square");
+
+    std::cout << tc_speculate_t<Show, Square>::show(shapes[0]) << std::endl;
+}
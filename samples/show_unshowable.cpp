@@ -8,8 +8,8 @@
 // This example shows how to select overload on the basis
 // of whether some type belongs to some typeclass or not.
 //
-// This is a conceptless analogue of show_concept.cpp, using explicit SFINAE 
-// and a lot of magic to make it work as intended...
+// This is a conceptless analogue of show_concept.cpp, using the 
+// tc_has_instance trait and a constrained instance (TC_INSTANCE_IF).
 //
 // Changes are marked with ##NEW##.
 
@@ -22,8 +22,6 @@ struct Show {
 // Show int
 template<>
 TC_INSTANCE(Show<int>, {
-    static void requirements () {} // ##NEW##
-
     static std::string show(int const & x) {
         return ("int"+std::to_string(x));
     }
@@ -34,8 +32,6 @@ struct Foo{};
 // Show Foo
 template<>
 TC_INSTANCE(Show<Foo>, {
-    static void requirements () {} // ##NEW##
-
     static std::string show(Foo const & x) {
         return "Foo";
     }
@@ -44,11 +40,8 @@ TC_INSTANCE(Show<Foo>, {
 
 
 // Show a => Show [a]
-template<class T>
-TC_INSTANCE(Show<std::vector<T>>, {
-    template<class P = _tc_impl_<Show<T>>, class Q = typename P::type>
-    static void requirements () {} // ##NEW##
-
+template<class T>  // ##NEW## the instance exists only if Show<T> exists
+TC_INSTANCE_IF(Show<std::vector<T>>, tc_require_t<Show<T>>, {
     static std::string show(std::vector<T> const & xs) {
         std::string res = "[";
 
@@ -69,27 +62,24 @@ TC_INSTANCE(Show<std::vector<T>>, {
 
 
 // print Show instances ##NEW## (now a function instead of an operator)
-template<class T,
-    class P = _tc_impl_<Show<T>>,
-    class Q = typename P::type,
-    class = decltype(Q::requirements())  // !!!!???!!!!
->
-std::ostream & operator_out(std::ostream & os, T const & x) {
-    std::operator<<(os, Q::show(x));
+template<class T>
+std::ostream & operator_out(std::ostream & os, T const & x, std::true_type) {
+    std::operator<<(os, tc_impl_t<Show<T>>::show(x));
     return os;
 }
 
 // ##NEW##
-template<class T, class... Dummy>  // less specific (a dirty hack...)
-std::ostream & operator_out(std::ostream & os, T const & x, Dummy...) {
+template<class T>
+std::ostream & operator_out(std::ostream & os, T const & x, std::false_type) {
     std::operator<<(os, "<UNSHOWABLE>");
     return os;
 }
 
-// ##NEW##
-template<class T> // another dirty hack (operator<< can't be defined with template varargs)
+// ##NEW## dispatch on the presence of an instance
+template<class T>
 std::ostream & operator<<(std::ostream & os, T const &x) {
-    return operator_out(os, x);
+    return operator_out(os, x, 
+        std::integral_constant<bool, tc_has_instance<Show<T>>::value>());
 }
 
 
@@ -109,8 +99,6 @@ struct DynShow {
 // We have to provide some Show instance to DynShow values.
 template<>
 TC_INSTANCE(Show<DynShow>, {
-    static void requirements () {} // ##NEW##
-
     static std::string show(DynShow const & x) {
         return x.show_me();
     }
@@ -138,8 +126,6 @@ std::unique_ptr<DynShow> to_show(T x) {
 // in rust this would be: impl<T: Show+?Sized> Show for Box<T> 
 template<class T>
 TC_INSTANCE(Show<std::unique_ptr<T>>, {
-    static void requirements () {} // ##NEW##
-
     static std::string show(std::unique_ptr<T> const & ptr) {
         return tc_impl_t<Show<T>>::show(*ptr);
     }
@@ -0,0 +1,565 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <deque>
+#include <chrono>
+#include <optional>
+#include <utility>
+#include <exception>
+#include <stdexcept>
+#include <coroutine>
+#include <algorithm>
+#include <assert.h>
+#include <poll.h>
+#include <unistd.h>
+#include "../tc.hpp"
+
+// Asynchronous tasks (C++20 coroutines) as instances of the
+// Functor/Applicative/Monad typeclasses (cf. functor.cpp), plus
+// a Generator with the instances of a list.
+//
+// A Task<T> starts when it is awaited (or run by the executor) and its
+// awaiter is resumed when it finishes. A single-threaded executor resumes
+// the ready coroutines and waits with poll() for timers and file
+// descriptors. Monad::bind awaits the stages one after another, while
+// Applicative::lift2 starts both tasks before awaiting them, so two
+// independent stages waiting for I/O overlap.
+
+
+// T has the kind * -> *
+template<template<class> class T>
+struct Functor {
+    template<class A, class F>
+    static auto fmap(T<A> xs, F f) -> T<decltype(f(std::declval<A>()))>
+    = delete;
+};
+
+template<template<class> class T>
+struct Applicative {
+    TC_REQUIRE(Functor<T>); // a superclass (cf. super.cpp)
+
+    template<class A>
+    static T<A> pure(A x) = delete;
+
+    // lift2(f, a, b): f applied to the results of a and b
+    template<class A, class B, class F>
+    static auto lift2(F f, T<A> a, T<B> b) -> T<decltype(f(std::declval<A>(), std::declval<B>()))>
+    = delete;
+};
+
+template<template<class> class T>
+struct Monad {
+    TC_REQUIRE(Applicative<T>);
+
+    // bind(x, f) where f: A -> T<B>
+    template<class A, class F>
+    static auto bind(T<A> x, F f) -> decltype(f(std::declval<A>()))
+    = delete;
+};
+
+
+// ------------------------------- the executor ------------------------------- //
+
+class Executor {
+    typedef std::chrono::steady_clock Clock;
+
+    struct Timer { Clock::time_point when; std::coroutine_handle<> h; };
+    struct Wait { int fd; short events; std::coroutine_handle<> h; };
+
+    std::deque<std::coroutine_handle<>> ready;
+    std::vector<Timer> timers;
+    std::vector<Wait> waits;
+
+    static Executor * & current_ptr() {
+        static thread_local Executor * current = nullptr;
+        return current;
+    }
+
+    // one turn: runs the ready coroutines, then waits for a timer or an fd
+    void turn() {
+        while (!ready.empty()) {
+            auto h = ready.front();
+            ready.pop_front();
+            h.resume();
+        }
+        if (timers.empty() && waits.empty()) return;
+
+        int timeout = -1;
+        if (!timers.empty()) {
+            auto first = std::min_element(timers.begin(), timers.end(),
+                [](Timer const & a, Timer const & b) { return a.when < b.when; });
+            auto ms = std::chrono::ceil<std::chrono::milliseconds>(first->when - Clock::now());
+            timeout = int(std::max<long long>(0, ms.count()));
+        }
+
+        std::vector<pollfd> fds;
+        for (auto const & w : waits) fds.push_back({ w.fd, w.events, 0 });
+        ::poll(fds.data(), fds.size(), timeout);
+
+        for (std::size_t i = fds.size(); i-- > 0; ) {
+            if (fds[i].revents) {
+                ready.push_back(waits[i].h);
+                waits.erase(waits.begin() + i);
+            }
+        }
+
+        auto now = Clock::now();
+        for (std::size_t i = 0; i < timers.size(); ) {
+            if (timers[i].when <= now) {
+                ready.push_back(timers[i].h);
+                timers.erase(timers.begin() + i);
+            } else {
+                i++;
+            }
+        }
+    }
+
+public:
+    static Executor & current() { return *current_ptr(); }
+
+    void schedule(std::coroutine_handle<> h) { ready.push_back(h); }
+
+    void wake_at(Clock::time_point when, std::coroutine_handle<> h) {
+        timers.push_back({ when, h });
+    }
+
+    void wake_on(int fd, short events, std::coroutine_handle<> h) {
+        waits.push_back({ fd, events, h });
+    }
+
+    // forgets a coroutine destroyed while suspended: the current executor,
+    // if any, must not resume it
+    static void cancel(std::coroutine_handle<> h) {
+        Executor * e = current_ptr();
+        if (!e) return;
+        e->ready.erase(std::remove(e->ready.begin(), e->ready.end(), h), e->ready.end());
+        e->timers.erase(std::remove_if(e->timers.begin(), e->timers.end(),
+            [h](Timer const & t) { return t.h == h; }), e->timers.end());
+        e->waits.erase(std::remove_if(e->waits.begin(), e->waits.end(),
+            [h](Wait const & w) { return w.h == h; }), e->waits.end());
+    }
+
+    // runs the executor until the task is finished; throws if the task
+    // waits for something which is neither ready, nor a timer, nor an fd
+    template<class Task>
+    auto run(Task task) {
+        struct Current {
+            Executor * previous = current_ptr();
+            explicit Current(Executor * e) { current_ptr() = e; }
+            ~Current() { current_ptr() = previous; }
+        } current(this);
+
+        // destroyed before `current`: its coroutines are cancelled here
+        Task t = std::move(task);
+
+        t.start();
+        while (!t.done()) {
+            if (ready.empty() && timers.empty() && waits.empty()) {
+                throw std::runtime_error("deadlock: the task waits for nothing");
+            }
+            turn();
+        }
+
+        return t.result();
+    }
+};
+
+// co_await sleep_for(ms)
+inline auto sleep_for(std::chrono::milliseconds ms) {
+    struct Awaiter {
+        std::chrono::milliseconds ms;
+
+        bool await_ready() const { return ms.count() <= 0; }
+        void await_suspend(std::coroutine_handle<> h) const {
+            Executor::current().wake_at(std::chrono::steady_clock::now() + ms, h);
+        }
+        void await_resume() const {}
+    };
+    return Awaiter{ ms };
+}
+
+// co_await readable(fd), co_await writable(fd)
+inline auto wait_fd(int fd, short events) {
+    struct Awaiter {
+        int fd;
+        short events;
+
+        bool await_ready() const { return false; }
+        void await_suspend(std::coroutine_handle<> h) const {
+            Executor::current().wake_on(fd, events, h);
+        }
+        void await_resume() const {}
+    };
+    return Awaiter{ fd, events };
+}
+
+inline auto readable(int fd) { return wait_fd(fd, POLLIN); }
+inline auto writable(int fd) { return wait_fd(fd, POLLOUT); }
+
+
+// --------------------------------- Task<T> --------------------------------- //
+
+template<class T>
+class Task {
+public:
+    struct promise_type {
+        std::optional<T> value;
+        std::exception_ptr error;
+        std::coroutine_handle<> continuation;
+        bool started = false;
+
+        Task get_return_object() {
+            return Task(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+
+        std::suspend_always initial_suspend() noexcept { return {}; }
+
+        // resumes the awaiter, if any
+        auto final_suspend() noexcept {
+            struct Final {
+                bool await_ready() noexcept { return false; }
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> h) noexcept {
+                    auto next = h.promise().continuation;
+                    return next ? next : std::noop_coroutine();
+                }
+                void await_resume() noexcept {}
+            };
+            return Final{};
+        }
+
+        void return_value(T x) { value.emplace(std::move(x)); }
+        void unhandled_exception() { error = std::current_exception(); }
+    };
+
+private:
+    std::coroutine_handle<promise_type> h;
+
+    explicit Task(std::coroutine_handle<promise_type> h): h(h) {}
+
+public:
+    Task(Task && other) noexcept: h(std::exchange(other.h, {})) {}
+
+    Task & operator=(Task && other) noexcept {
+        std::swap(h, other.h);
+        return *this;
+    }
+
+    // a task destroyed before finishing is cancelled
+    ~Task() {
+        if (!h) return;
+        if (h.promise().started && !h.done()) Executor::cancel(h);
+        h.destroy();
+    }
+
+    // schedules the task on the current executor without awaiting it
+    void start() {
+        if (h.promise().started) return;
+        h.promise().started = true;
+        Executor::current().schedule(h);
+    }
+
+    bool done() const { return h.done(); }
+
+    T result() {
+        if (h.promise().error) std::rethrow_exception(h.promise().error);
+        return std::move(*h.promise().value);
+    }
+
+    // the awaiter of a not started task starts it by a direct transfer,
+    // the awaiter of a started task is resumed when it finishes
+    template<bool with_result>
+    struct Awaiter {
+        Task & task;
+
+        bool await_ready() const { return task.h.done(); }
+
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiter) {
+            auto & p = task.h.promise();
+            p.continuation = awaiter;
+            if (p.started) return std::noop_coroutine();
+            p.started = true;
+            return task.h;
+        }
+
+        auto await_resume() {
+            if constexpr (with_result) return task.result();
+        }
+    };
+
+    Awaiter<true> operator co_await() && { return { *this }; }
+
+    // co_await t.finished(): waits without taking the result (or the exception)
+    Awaiter<false> finished() & { return { *this }; }
+};
+
+
+template<>
+TC_INSTANCE(Functor<Task>, {
+    template<class A, class F>
+    static auto fmap(Task<A> t, F f) -> Task<decltype(f(std::declval<A>()))> {
+        co_return f(co_await std::move(t));
+    }
+});
+
+template<>
+TC_INSTANCE(Applicative<Task>, {
+    template<class A>
+    static Task<A> pure(A x) {
+        co_return x;
+    }
+
+    // both tasks are started before either is awaited, and both
+    // are finished before an exception of either is rethrown
+    template<class A, class B, class F>
+    static auto lift2(F f, Task<A> a, Task<B> b)
+        -> Task<decltype(f(std::declval<A>(), std::declval<B>()))>
+    {
+        a.start();
+        b.start();
+        co_await a.finished();
+        co_await b.finished();
+        co_return f(a.result(), b.result());
+    }
+});
+
+template<>
+TC_INSTANCE(Monad<Task>, {
+    template<class A, class F>
+    static auto bind(Task<A> t, F f) -> decltype(f(std::declval<A>())) {
+        co_return co_await f(co_await std::move(t));
+    }
+});
+
+
+// ------------------------------- Generator<T> ------------------------------- //
+
+// A synchronous generator: the body runs when the next value is pulled.
+template<class T>
+class Generator {
+public:
+    struct promise_type {
+        T const * current = nullptr;
+        std::exception_ptr error;
+
+        Generator get_return_object() {
+            return Generator(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+
+        std::suspend_always yield_value(T const & x) noexcept {
+            current = &x;
+            return {};
+        }
+
+        void return_void() {}
+        void unhandled_exception() { error = std::current_exception(); }
+    };
+
+private:
+    std::coroutine_handle<promise_type> h;
+
+    explicit Generator(std::coroutine_handle<promise_type> h): h(h) {}
+
+    void advance() {
+        h.resume();
+        if (h.promise().error) std::rethrow_exception(h.promise().error);
+    }
+
+public:
+    Generator(Generator && other) noexcept: h(std::exchange(other.h, {})) {}
+    ~Generator() { if (h) h.destroy(); }
+
+    struct iterator {
+        Generator * g;
+
+        T const & operator*() const { return *g->h.promise().current; }
+        iterator & operator++() { g->advance(); return *this; }
+        bool operator==(std::default_sentinel_t) const { return g->h.done(); }
+    };
+
+    iterator begin() { advance(); return { this }; }
+    std::default_sentinel_t end() { return {}; }
+};
+
+
+template<>
+TC_INSTANCE(Functor<Generator>, {
+    template<class A, class F>
+    static auto fmap(Generator<A> xs, F f) -> Generator<decltype(f(std::declval<A>()))> {
+        for (auto const & x : xs) co_yield f(x);
+    }
+});
+
+// the instances of a list: all the combinations
+template<>
+TC_INSTANCE(Applicative<Generator>, {
+    template<class A>
+    static Generator<A> pure(A x) {
+        co_yield x;
+    }
+
+    template<class A, class B, class F>
+    static auto lift2(F f, Generator<A> as, Generator<B> bs)
+        -> Generator<decltype(f(std::declval<A>(), std::declval<B>()))>
+    {
+        std::vector<B> ys; // a generator can be traversed only once
+        for (auto const & y : bs) ys.push_back(y);
+
+        for (auto const & x : as) {
+            for (auto const & y : ys) co_yield f(x, y);
+        }
+    }
+});
+
+template<>
+TC_INSTANCE(Monad<Generator>, {
+    template<class A, class F>
+    static auto bind(Generator<A> xs, F f) -> decltype(f(std::declval<A>())) {
+        for (auto const & x : xs) {
+            for (auto const & y : f(x)) co_yield y;
+        }
+    }
+});
+
+
+// ------------------------- a loopback I/O stand-in ------------------------- //
+
+struct Pipe {
+    int fds[2];
+
+    Pipe() { if (::pipe(fds) != 0) throw std::runtime_error("pipe"); }
+    ~Pipe() { ::close(fds[0]); ::close(fds[1]); }
+
+    int read_end() const { return fds[0]; }
+    int write_end() const { return fds[1]; }
+};
+
+// the "server": answers after a delay
+Task<std::size_t> respond(int fd, std::chrono::milliseconds delay, std::string text) {
+    co_await sleep_for(delay);
+    co_await writable(fd);
+    co_return std::size_t(::write(fd, text.data(), text.size()));
+}
+
+// a request: waits for the answer on a pipe
+Task<std::string> request(std::chrono::milliseconds delay, std::string text) {
+    Pipe pipe;
+    Task<std::size_t> server = respond(pipe.write_end(), delay, text);
+    server.start();
+
+    co_await readable(pipe.read_end());
+    char buf[256];
+    ssize_t n = ::read(pipe.read_end(), buf, sizeof(buf));
+
+    co_await std::move(server);
+    co_return std::string(buf, n > 0 ? std::size_t(n) : 0);
+}
+
+Generator<int> range(int from, int to) {
+    for (int i = from; i < to; i++) co_yield i;
+}
+
+// abandons two requests: one not run yet, one waiting for its answer
+Task<int> abandon(std::chrono::milliseconds delay) {
+    {
+        Task<std::string> queued = request(delay, "queued");
+        queued.start();
+    }
+    {
+        Task<std::string> waiting = request(delay, "waiting");
+        waiting.start();
+        co_await sleep_for(delay / 2);
+    }
+    co_await sleep_for(delay);
+    co_return 1;
+}
+
+// waits for something no one will ever do
+Task<int> stuck() {
+    co_await std::suspend_always{};
+    co_return 0;
+}
+
+Task<int> fail() {
+    throw std::runtime_error("failed");
+    co_return 0;
+}
+
+
+int main() {
+    using namespace std::chrono;
+    TC_IMPL(Functor<Task>) FT;
+    TC_IMPL(Applicative<Task>) AT;
+    TC_IMPL(Monad<Task>) MT;
+
+    Executor executor;
+    milliseconds const delay(100);
+    auto concat = [](std::string a, std::string b) { return a + " " + b; };
+
+    // sequential stages: the second request starts when the first is done
+    auto start = steady_clock::now();
+    std::string seq = executor.run(MT::bind(request(delay, "hello"), [&](std::string a) {
+        return FT::fmap(request(delay, "world"), [a](std::string b) { return a + " " + b; });
+    }));
+    auto seq_time = steady_clock::now() - start;
+
+    // independent stages: both requests wait at the same time
+    start = steady_clock::now();
+    std::string par = executor.run(AT::lift2(concat, request(delay, "hello"), request(delay, "world")));
+    auto par_time = steady_clock::now() - start;
+
+    std::cout << seq << ": " << duration_cast<milliseconds>(seq_time).count() << " ms" << std::endl;
+    std::cout << par << ": " << duration_cast<milliseconds>(par_time).count() << " ms" << std::endl;
+    assert(seq == "hello world" && par == seq);
+    assert(seq_time >= 2 * delay && par_time < seq_time * 3 / 4);
+
+    // exceptions are propagated to the awaiter
+    bool caught = false;
+    try {
+        executor.run(FT::fmap(fail(), [](int x) { return x + 1; }));
+    } catch (std::runtime_error const &) {
+        caught = true;
+    }
+    assert(caught);
+
+    // ...after the other stage has finished
+    caught = false;
+    try {
+        executor.run(AT::lift2([](int x, std::string) { return x; }, fail(), request(delay, "late")));
+    } catch (std::runtime_error const &) {
+        caught = true;
+    }
+    assert(caught);
+    assert(executor.run(AT::pure(42)) == 42);
+
+    // destroyed tasks are not resumed
+    assert(executor.run(abandon(delay)) == 1);
+
+    // a deadlock is reported
+    caught = false;
+    try {
+        executor.run(stuck());
+    } catch (std::runtime_error const &) {
+        caught = true;
+    }
+    assert(caught);
+
+    // generators
+    TC_IMPL(Functor<Generator>) FG;
+    TC_IMPL(Applicative<Generator>) AG;
+    TC_IMPL(Monad<Generator>) MG;
+
+    std::vector<int> squares, pairs, nested;
+    for (int x : FG::fmap(range(1, 5), [](int x) { return x * x; })) squares.push_back(x);
+    for (int x : AG::lift2([](int a, int b) { return a * 10 + b; }, range(1, 3), range(1, 4))) pairs.push_back(x);
+    for (int x : MG::bind(range(1, 4), [](int n) { return range(0, n); })) nested.push_back(x);
+
+    assert((squares == std::vector<int>{1, 4, 9, 16}));
+    assert((pairs == std::vector<int>{11, 12, 13, 21, 22, 23}));
+    assert((nested == std::vector<int>{0, 0, 1, 0, 1, 2}));
+
+    for (int x : pairs) std::cout << x << " ";
+    std::cout << std::endl;
+}
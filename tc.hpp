@@ -8,18 +8,15 @@
 #ifndef _TC_HPP_
 #define _TC_HPP_
 
-// Minumum requirements for the macros below: C++98 with variadic macros
-
-template<class T> struct _tc_impl_;
-
-#define TC_INSTANCE(tc, body...) \
-    struct _tc_impl_< tc > { typedef struct: tc body type; };
+// Minumum requirements for the macros: C++98 with variadic macros
+//
+// The macros live in tc_macros.hpp (so that they can be used together
+// with the C++20 module `tc`, see the module directory).
 
-#define TC_IMPL(tc...) typedef typename _tc_impl_< tc >::type
+// the second parameter is used only by constrained instances (TC_INSTANCE_IF)
+template<class T, class = void> struct _tc_impl_;
 
-// wrap the first argument to the TC_INSTANCE macro if it contains commas
-#define TC(x...) x
-// a somewhat uglier alternative is to #define COMMA ,
+#include "tc_macros.hpp"
 
 
 // Usage example:
@@ -49,6 +46,9 @@ template<class T> struct _tc_impl_;
 // TC_IMPL(MyClass< MyType<args> >) some_name;
 // some_name::foo();
 //
+// Methods may be constexpr: an instance is an ordinary struct, so its 
+// methods can be used in constant expressions (see show_constexpr.cpp).
+//
 
 #if __cplusplus >= 201103L
 
@@ -56,9 +56,30 @@ template<class T> struct _tc_impl_;
 template<class T> using tc_impl_t = typename _tc_impl_<T>::type;
 
 // a mechanism for putting constraints on instantiations or definitions
+// (used by TC_REQUIRE)
 template<class T> struct _tc_dummy_ { static bool const value = true; T t; };
-#define TC_REQUIRE(tc...) \
-    static_assert( _tc_dummy_<tc_impl_t<tc>>::value, "unreachable" );
+
+// a compile-time test for an instance: tc_has_instance<MyClass<MyType>>::value
+//
+// Only the declaration of the instance is checked (its body is not 
+// instantiated), so the constraints should be put on the declaration 
+// (see TC_INSTANCE_IF) rather than inside the body (TC_REQUIRE).
+template<class TC> char _tc_has_(typename _tc_impl_<TC>::type *);
+template<class TC> long _tc_has_(...);
+template<class TC> 
+struct tc_has_instance { static bool const value = sizeof(_tc_has_<TC>(0)) == 1; };
+
+// void if all the instances exist, a substitution failure otherwise
+template<bool> struct _tc_enable_ {};
+template<> struct _tc_enable_<true> { typedef void type; };
+
+template<bool...> struct _tc_bools_ {};
+template<class A, class B> struct _tc_same_ { static bool const value = false; };
+template<class A> struct _tc_same_<A, A> { static bool const value = true; };
+
+template<class... TC> using tc_require_t = typename _tc_enable_< _tc_same_< 
+    _tc_bools_<true, tc_has_instance<TC>::value...>, 
+    _tc_bools_<tc_has_instance<TC>::value..., true> >::value >::type;
 
 #endif // c++11
 
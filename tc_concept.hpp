@@ -3,8 +3,10 @@
 
 #include "tc.hpp"
 
+// Only the existence of the instance is checked: unlike TC_REQUIRE,
+// the instance itself is not instantiated.
 template<class TC>
-concept Instance = _tc_dummy_<tc_impl_t<TC>>::value;
+concept Instance = requires { typename _tc_impl_<TC>::type; };
 
 
 
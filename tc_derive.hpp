@@ -0,0 +1,191 @@
+// Deriving typeclass instances for aggregates.
+//
+// The fields of a struct are listed once:
+//
+// struct Point { int x, y; };
+// TC_FIELDS(Point, x, y)
+//
+// and then instances of typeclasses which know how to derive themselves
+// are generated from the list:
+//
+// TC_DERIVE(Point, Eq, Show)
+//
+// A typeclass supports deriving with a specialization of tc_derived 
+// defining its methods in terms of the fields (it usually inherits 
+// the typeclass, so that the default methods are kept):
+//
+// template<class T>
+// struct tc_derived<Eq<T>>: Eq<T> {
+//     static bool equal(T const & a, T const & b) {
+//         return !tc_first_field2(a, b, [](auto const & x, auto const & y) {
+//             return !tc_impl_t<Eq<std::decay_t<decltype(x)>>>::equal(x, y);
+//         });
+//     }
+// };
+//
+// The field accessors are inline functions, so derived methods compile 
+// to the same code as hand-written ones (see bench/derive_codegen.cpp).
+//
+// Requires C++14. At most 32 fields.
+
+#ifndef _TC_DERIVE_HPP_
+#define _TC_DERIVE_HPP_
+
+#include <cstddef>
+#include <initializer_list>
+#include <type_traits>
+#include <utility>
+#include "tc.hpp"
+
+
+// specialized by TC_FIELDS:
+//   size                       the number of fields
+//   get(x, tc_field_index<I>)  a reference to the field I of x
+//   name(tc_field_index<I>)    its name
+template<class T> struct tc_fields;
+
+// specialized by the typeclasses supporting TC_DERIVE
+template<class TC> struct tc_derived;
+
+template<std::size_t I> using tc_field_index = std::integral_constant<std::size_t, I>;
+
+// the type of the field I of T
+template<class T, std::size_t I>
+using tc_field_t = typename std::remove_cv<typename std::remove_reference<
+    decltype(tc_fields<T>::get(std::declval<T const &>(), tc_field_index<I>()))
+>::type>::type;
+
+
+// calls f(name, field) for every field of x in order
+template<class T, class F, std::size_t... I>
+void _tc_each_field_(T const & x, F & f, std::index_sequence<I...>) {
+    typedef tc_fields<T> Fs;
+    int dummy[] = { 0, (f(Fs::name(tc_field_index<I>()), Fs::get(x, tc_field_index<I>())), 0)... };
+    (void)dummy;
+}
+
+template<class T, class F>
+void tc_each_field(T const & x, F f) {
+    _tc_each_field_(x, f, std::make_index_sequence<tc_fields<T>::size>());
+}
+
+// calls f(field of x, field of y) for the fields in order and returns 
+// the first result which is true when converted to bool (or R() if there 
+// is none), e.g. the first non-zero comparison
+template<std::size_t I, std::size_t N>
+struct _tc_first_field2_ {
+    template<class R, class T, class F>
+    static R run(T const & x, T const & y, F & f) {
+        typedef tc_fields<T> Fs;
+        R r = f(Fs::get(x, tc_field_index<I>()), Fs::get(y, tc_field_index<I>()));
+        return r ? r : _tc_first_field2_<I + 1, N>::template run<R>(x, y, f);
+    }
+};
+
+template<std::size_t N>
+struct _tc_first_field2_<N, N> {
+    template<class R, class T, class F>
+    static R run(T const &, T const &, F &) { return R(); }
+};
+
+template<class T, class F>
+auto tc_first_field2(T const & x, T const & y, F f) 
+    -> decltype(f(tc_fields<T>::get(x, tc_field_index<0>()), 
+                  tc_fields<T>::get(y, tc_field_index<0>()))) 
+{
+    typedef decltype(f(tc_fields<T>::get(x, tc_field_index<0>()), 
+                       tc_fields<T>::get(y, tc_field_index<0>()))) R;
+    return _tc_first_field2_<0, tc_fields<T>::size>::template run<R>(x, y, f);
+}
+
+
+constexpr bool _tc_and_(std::initializer_list<bool> bs) {
+    for (bool b: bs) if (!b) return false;
+    return true;
+}
+
+constexpr std::size_t _tc_sum_(std::initializer_list<std::size_t> xs) {
+    std::size_t s = 0;
+    for (std::size_t x: xs) s += x;
+    return s;
+}
+
+template<class T, template<class> class P, class Is>
+struct _tc_fields_all_;
+
+template<class T, template<class> class P, std::size_t... I>
+struct _tc_fields_all_<T, P, std::index_sequence<I...>>: std::integral_constant<bool,
+    sizeof(T) == _tc_sum_({ std::size_t(0), sizeof(tc_field_t<T, I>)... }) &&
+    _tc_and_({ true, P<tc_field_t<T, I>>::value... })
+> {};
+
+// true if T has TC_FIELDS, they cover all of its bytes (no padding, 
+// no unlisted fields) and P<Field>::value holds for every field: 
+// e.g. T may be compared with memcmp if all its fields may
+template<class T, template<class> class P, class = void>
+struct tc_fields_all: std::false_type {};
+
+template<class T, template<class> class P>
+struct tc_fields_all<T, P, decltype(void(tc_fields<T>::size))>: 
+    _tc_fields_all_<T, P, std::make_index_sequence<tc_fields<T>::size>> {};
+
+
+#define _TC_FE_1(m, a, x1) m(a, 0, x1)
+#define _TC_FE_2(m, a, x1, x2) _TC_FE_1(m, a, x1) m(a, 1, x2)
+#define _TC_FE_3(m, a, x1, x2, x3) _TC_FE_2(m, a, x1, x2) m(a, 2, x3)
+#define _TC_FE_4(m, a, x1, x2, x3, x4) _TC_FE_3(m, a, x1, x2, x3) m(a, 3, x4)
+#define _TC_FE_5(m, a, x1, x2, x3, x4, x5) _TC_FE_4(m, a, x1, x2, x3, x4) m(a, 4, x5)
+#define _TC_FE_6(m, a, x1, x2, x3, x4, x5, x6) _TC_FE_5(m, a, x1, x2, x3, x4, x5) m(a, 5, x6)
+#define _TC_FE_7(m, a, x1, x2, x3, x4, x5, x6, x7) _TC_FE_6(m, a, x1, x2, x3, x4, x5, x6) m(a, 6, x7)
+#define _TC_FE_8(m, a, x1, x2, x3, x4, x5, x6, x7, x8) _TC_FE_7(m, a, x1, x2, x3, x4, x5, x6, x7) m(a, 7, x8)
+#define _TC_FE_9(m, a, x1, x2, x3, x4, x5, x6, x7, x8, x9) _TC_FE_8(m, a, x1, x2, x3, x4, x5, x6, x7, x8) m(a, 8, x9)
+#define _TC_FE_10(m, a, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10) _TC_FE_9(m, a, x1, x2, x3, x4, x5, x6, x7, x8, x9) m(a, 9, x10)
+#define _TC_FE_11(m, a, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11) _TC_FE_10(m, a, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10) m(a, 10, x11)
+#define _TC_FE_12(m, a, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12) _TC_FE_11(m, a, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11) m(a, 11, x12)
+#define _TC_FE_13(m, a, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13) _TC_FE_12(m, a, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12) m(a, 12, x13)
+#define _TC_FE_14(m, a, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14) _TC_FE_13(m, a, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13) m(a, 13, x14)
+#define _TC_FE_15(m, a, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15) _TC_FE_14(m, a, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14) m(a, 14, x15)
+#define _TC_FE_16(m, a, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15, x16) _TC_FE_15(m, a, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15) m(a, 15, x16)
+#define _TC_FE_17(m, a, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15, x16, x17) _TC_FE_16(m, a, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15, x16) m(a, 16, x17)
+#define _TC_FE_18(m, a, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15, x16, x17, x18) _TC_FE_17(m, a, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15, x16, x17) m(a, 17, x18)
+#define _TC_FE_19(m, a, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15, x16, x17, x18, x19) _TC_FE_18(m, a, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15, x16, x17, x18) m(a, 18, x19)
+#define _TC_FE_20(m, a, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15, x16, x17, x18, x19, x20) _TC_FE_19(m, a, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15, x16, x17, x18, x19) m(a, 19, x20)
+#define _TC_FE_21(m, a, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15, x16, x17, x18, x19, x20, x21) _TC_FE_20(m, a, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15, x16, x17, x18, x19, x20) m(a, 20, x21)
+#define _TC_FE_22(m, a, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15, x16, x17, x18, x19, x20, x21, x22) _TC_FE_21(m, a, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15, x16, x17, x18, x19, x20, x21) m(a, 21, x22)
+#define _TC_FE_23(m, a, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15, x16, x17, x18, x19, x20, x21, x22, x23) _TC_FE_22(m, a, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15, x16, x17, x18, x19, x20, x21, x22) m(a, 22, x23)
+#define _TC_FE_24(m, a, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15, x16, x17, x18, x19, x20, x21, x22, x23, x24) _TC_FE_23(m, a, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15, x16, x17, x18, x19, x20, x21, x22, x23) m(a, 23, x24)
+#define _TC_FE_25(m, a, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15, x16, x17, x18, x19, x20, x21, x22, x23, x24, x25) _TC_FE_24(m, a, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15, x16, x17, x18, x19, x20, x21, x22, x23, x24) m(a, 24, x25)
+#define _TC_FE_26(m, a, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15, x16, x17, x18, x19, x20, x21, x22, x23, x24, x25, x26) _TC_FE_25(m, a, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15, x16, x17, x18, x19, x20, x21, x22, x23, x24, x25) m(a, 25, x26)
+#define _TC_FE_27(m, a, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15, x16, x17, x18, x19, x20, x21, x22, x23, x24, x25, x26, x27) _TC_FE_26(m, a, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15, x16, x17, x18, x19, x20, x21, x22, x23, x24, x25, x26) m(a, 26, x27)
+#define _TC_FE_28(m, a, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15, x16, x17, x18, x19, x20, x21, x22, x23, x24, x25, x26, x27, x28) _TC_FE_27(m, a, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15, x16, x17, x18, x19, x20, x21, x22, x23, x24, x25, x26, x27) m(a, 27, x28)
+#define _TC_FE_29(m, a, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15, x16, x17, x18, x19, x20, x21, x22, x23, x24, x25, x26, x27, x28, x29) _TC_FE_28(m, a, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15, x16, x17, x18, x19, x20, x21, x22, x23, x24, x25, x26, x27, x28) m(a, 28, x29)
+#define _TC_FE_30(m, a, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15, x16, x17, x18, x19, x20, x21, x22, x23, x24, x25, x26, x27, x28, x29, x30) _TC_FE_29(m, a, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15, x16, x17, x18, x19, x20, x21, x22, x23, x24, x25, x26, x27, x28, x29) m(a, 29, x30)
+#define _TC_FE_31(m, a, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15, x16, x17, x18, x19, x20, x21, x22, x23, x24, x25, x26, x27, x28, x29, x30, x31) _TC_FE_30(m, a, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15, x16, x17, x18, x19, x20, x21, x22, x23, x24, x25, x26, x27, x28, x29, x30) m(a, 30, x31)
+#define _TC_FE_32(m, a, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15, x16, x17, x18, x19, x20, x21, x22, x23, x24, x25, x26, x27, x28, x29, x30, x31, x32) _TC_FE_31(m, a, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15, x16, x17, x18, x19, x20, x21, x22, x23, x24, x25, x26, x27, x28, x29, x30, x31) m(a, 31, x32)
+
+#define _TC_FE_PICK_(_1, _2, _3, _4, _5, _6, _7, _8, _9, _10, _11, _12, _13, _14, _15, _16, _17, _18, _19, _20, _21, _22, _23, _24, _25, _26, _27, _28, _29, _30, _31, _32, name, ...) name
+#define _TC_FOR_EACH_(m, a, xs...) \
+    _TC_FE_PICK_(xs, _TC_FE_32, _TC_FE_31, _TC_FE_30, _TC_FE_29, _TC_FE_28, _TC_FE_27, _TC_FE_26, _TC_FE_25, _TC_FE_24, _TC_FE_23, _TC_FE_22, _TC_FE_21, _TC_FE_20, _TC_FE_19, _TC_FE_18, _TC_FE_17, _TC_FE_16, _TC_FE_15, _TC_FE_14, _TC_FE_13, _TC_FE_12, _TC_FE_11, _TC_FE_10, _TC_FE_9, _TC_FE_8, _TC_FE_7, _TC_FE_6, _TC_FE_5, _TC_FE_4, _TC_FE_3, _TC_FE_2, _TC_FE_1)(m, a, xs)
+
+#define _TC_FIELD_(t, i, f) \
+    static auto get(t const & _tc_x_, tc_field_index<i>) -> decltype((_tc_x_.f)) { \
+        return _tc_x_.f; \
+    } \
+    static constexpr char const * name(tc_field_index<i>) { return #f; }
+
+#define _TC_DERIVE_(t, i, tc) \
+    template<> struct _tc_impl_< tc< t > > { typedef tc_derived< tc< t > > type; };
+
+// TC_FIELDS(Type, field1, field2, ...)
+// (the Type must not contain commas: use a typedef)
+#define TC_FIELDS(t, fields...) \
+    template<> struct tc_fields< t > { \
+        static constexpr std::size_t size = _TC_FE_PICK_(fields, 32, 31, 30, 29, 28, 27, 26, 25, 24, 23, 22, 21, 20, 19, 18, 17, 16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1); \
+        _TC_FOR_EACH_(_TC_FIELD_, t, fields) \
+    };
+
+// TC_DERIVE(Type, Class1, Class2, ...): instances Class1<Type>, ...
+#define TC_DERIVE(t, tcs...) _TC_FOR_EACH_(_TC_DERIVE_, t, tcs)
+
+
+#endif // _TC_DERIVE_HPP_
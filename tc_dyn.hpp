@@ -0,0 +1,397 @@
+// ------------------------------------------ //
+//    Generated existentials for tc.hpp       //
+// ------------------------------------------ //
+//
+// Instead of a hand-written abstract class (DynShow), a wrapper 
+// template (DynShowWrapper) and a forwarding instance (see show.cpp), 
+// the TC_DYN macro generates for a one-parametric typeclass:
+//
+//   * a table of function pointers (one per method), a constexpr 
+//     instance of which exists for every type implementing the typeclass;
+//   * instances of the typeclass for the erased types tc_dyn<Class>
+//     (a heap-allocated value), tc_dyn_in<Class> (a value placed 
+//     in an arena or a memory resource) and tc_dyn_ref<Class> (a 
+//     borrowed value: two pointers, trivially copyable).
+//
+// A method call on tc_dyn<Class> is a single indirect call through 
+// the table: no virtual functions, no RTTI.
+//
+// When a call site is dominated by one concrete type T, the call can be 
+// speculatively devirtualized: tc_speculate_t<Class, T> has the same 
+// methods, which compare the table with the one of T and call the 
+// instance of T directly (so it can be inlined), or fall back to the 
+// indirect call. Per-site hit/miss counts are kept by a tc_dyn_site, 
+// and with TC_DYN_PROFILE defined (in the whole program) the site also 
+// records the most frequent types, to choose T.
+//
+// Requirements: C++14. 
+// Every dynamized method takes the value as its first parameter 
+// `T const &`.
+//
+// Usage example:
+//
+// template<class T>
+// struct Foo {
+//     static void foo(T const & x, int y) = delete;
+//     static int bar(T const & x) = delete;
+// };
+//
+// #define FOO_METHODS(m) m(foo, void(int)) m(bar, int())
+//
+// TC_DYN(Foo, FOO_METHODS)
+//
+// tc_dyn<Foo> x = to_dyn<Foo>(some_value);
+// tc_impl_t<Foo<tc_dyn<Foo>>>::foo(x, 1);
+//
+// std::pmr::monotonic_buffer_resource arena;
+// tc_dyn_in<Foo> y = to_dyn_in<Foo>(arena, some_value);
+// tc_impl_t<Foo<tc_dyn_in<Foo>>>::bar(y);
+//
+// void print(tc_dyn_ref<Foo> r) {         // not a template, no boxing
+//     tc_impl_t<Foo<tc_dyn_ref<Foo>>>::foo(r, 1);
+// }
+// print(some_lvalue);
+//
+// tc_speculate_t<Foo, int>::bar(x);       // inlined if x holds an int
+//
+// static tc_dyn_site site("bar in main");
+// tc_speculate_t<Foo, int>::bar(site, x); // the same, counted
+// site.report();
+//
+
+#ifndef _TC_DYN_HPP_
+#define _TC_DYN_HPP_
+
+#include <new>
+#include <cstdio>
+#include <utility>
+#include <type_traits>
+#include "tc.hpp"
+#ifdef TC_DYN_PROFILE
+#include "tc_type_name.hpp"
+#endif
+
+// the table of the existential `dyn TC`, defined by TC_DYN
+template<template<class> class TC> struct _tc_dyn_vtable_;
+
+// a method signature R(Args...) is stored as R(*)(void const *, Args...)
+template<class Sig> struct _tc_dyn_fn_;
+
+template<class R, class... Args> 
+struct _tc_dyn_fn_<R(Args...)> {
+    typedef R (*type)(void const *, Args...);
+};
+
+// the result type R of a signature R(Args...)
+template<class Sig> struct _tc_dyn_ret_;
+
+template<class R, class... Args> 
+struct _tc_dyn_ret_<R(Args...)> {
+    typedef R type;
+};
+
+// the table for a concrete type T (one per program)
+template<template<class> class TC, class T>
+struct _tc_dyn_table_ {
+    static constexpr _tc_dyn_vtable_<TC> value = 
+        _tc_dyn_vtable_<TC>::template make<T>();
+};
+
+template<template<class> class TC, class T>
+constexpr _tc_dyn_vtable_<TC> _tc_dyn_table_<TC, T>::value;
+
+
+// An owning existential: a heap-allocated value and its table.
+template<template<class> class TC>
+class tc_dyn {
+    void * self;
+    _tc_dyn_vtable_<TC> const * vt;
+
+    tc_dyn(void * self, _tc_dyn_vtable_<TC> const * vt): self(self), vt(vt) {}
+
+public:
+    // in-place constructor: make<T>(constructor arguments of T)
+    template<class T, class... Args>
+    static tc_dyn make(Args && ... args) {
+        return tc_dyn(new T(std::forward<Args>(args)...), 
+                      &_tc_dyn_table_<TC, T>::value);
+    }
+
+    tc_dyn(tc_dyn && other) noexcept: self(other.self), vt(other.vt) {
+        other.self = nullptr;
+    }
+
+    tc_dyn & operator=(tc_dyn && other) noexcept {
+        std::swap(self, other.self);
+        std::swap(vt, other.vt);
+        return *this;
+    }
+
+    tc_dyn(tc_dyn const &) = delete;
+    tc_dyn & operator=(tc_dyn const &) = delete;
+
+    ~tc_dyn() { if (self) vt->drop(self); }
+
+    void const * get() const { return self; }
+    _tc_dyn_vtable_<TC> const * vtable() const { return vt; }
+};
+
+// type-inferring constructor
+template<template<class> class TC, class T>
+tc_dyn<TC> to_dyn(T && x) {
+    return tc_dyn<TC>::template make<typename std::decay<T>::type>(
+        std::forward<T>(x));
+}
+
+
+// An owning existential for a value placed in memory owned by someone 
+// else (an arena, a std::pmr::memory_resource): the destructor destroys 
+// the value (nothing for trivially destructible types) but doesn't free 
+// the memory, which is released all at once by its owner.
+template<template<class> class TC>
+class tc_dyn_in {
+    void * self;
+    _tc_dyn_vtable_<TC> const * vt;
+
+    tc_dyn_in(void * self, _tc_dyn_vtable_<TC> const * vt): self(self), vt(vt) {}
+
+public:
+    // make<T>(resource, constructor arguments of T), where the resource 
+    // is anything with an allocate(bytes, alignment) method
+    template<class T, class Resource, class... Args>
+    static tc_dyn_in make(Resource & resource, Args && ... args) {
+        void * p = resource.allocate(sizeof(T), alignof(T));
+        return tc_dyn_in(new (p) T(std::forward<Args>(args)...), 
+                         &_tc_dyn_table_<TC, T>::value);
+    }
+
+    tc_dyn_in(tc_dyn_in && other) noexcept: self(other.self), vt(other.vt) {
+        other.self = nullptr;
+    }
+
+    tc_dyn_in & operator=(tc_dyn_in && other) noexcept {
+        std::swap(self, other.self);
+        std::swap(vt, other.vt);
+        return *this;
+    }
+
+    tc_dyn_in(tc_dyn_in const &) = delete;
+    tc_dyn_in & operator=(tc_dyn_in const &) = delete;
+
+    ~tc_dyn_in() { if (self && vt->destroy) vt->destroy(self); }
+
+    void const * get() const { return self; }
+    _tc_dyn_vtable_<TC> const * vtable() const { return vt; }
+};
+
+// type-inferring constructor
+template<template<class> class TC, class Resource, class T>
+tc_dyn_in<TC> to_dyn_in(Resource & resource, T && x) {
+    return tc_dyn_in<TC>::template make<typename std::decay<T>::type>(
+        resource, std::forward<T>(x));
+}
+
+
+// A non-owning existential: a pointer to an lvalue and its table, 
+// passed by value (in two registers). The value must outlive the 
+// reference, so temporaries are rejected.
+template<template<class> class TC>
+class tc_dyn_ref {
+    void const * self;
+    _tc_dyn_vtable_<TC> const * vt;
+
+    template<class T>
+    using _tc_borrowable_ = typename std::enable_if<
+        !std::is_same<typename std::decay<T>::type, tc_dyn_ref>::value,
+        tc_require_t<TC<typename std::decay<T>::type>> >::type;
+
+public:
+    template<class T, class = _tc_borrowable_<T>>
+    tc_dyn_ref(T const & x): self(&x), vt(&_tc_dyn_table_<TC, T>::value) {}
+
+    template<class T, class = _tc_borrowable_<T>,
+             class = typename std::enable_if<!std::is_lvalue_reference<T>::value>::type>
+    tc_dyn_ref(T && x) = delete;
+
+    // borrows the value of an owning existential (no double indirection)
+    tc_dyn_ref(tc_dyn<TC> const & x): self(x.get()), vt(x.vtable()) {}
+    tc_dyn_ref(tc_dyn_in<TC> const & x): self(x.get()), vt(x.vtable()) {}
+
+    void const * get() const { return self; }
+    _tc_dyn_vtable_<TC> const * vtable() const { return vt; }
+};
+
+
+// Hit/miss statistics of a speculative call site. The counters are not 
+// synchronized: use a thread_local site in multi-threaded code.
+class tc_dyn_site {
+public:
+    struct entry {
+        void const * vtable;
+        char const * type; // the name of the type with TC_DYN_PROFILE
+        unsigned long long count;
+    };
+
+    static constexpr int tracked = 4;
+
+private:
+    char const * name;
+    unsigned long long hits = 0, misses = 0;
+    entry top[tracked] = {};
+
+public:
+    explicit tc_dyn_site(char const * name): name(name) {}
+
+    void record(void const * vtable, char const * type, bool hit) {
+        ++(hit ? hits : misses);
+#ifdef TC_DYN_PROFILE
+        // the space-saving algorithm: the tracked type with the least 
+        // count is replaced by a new one, which inherits the count
+        int least = 0;
+        for (int i = 0; i < tracked; i++) {
+            if (top[i].vtable == vtable) { top[i].count++; return; }
+            if (top[i].count < top[least].count) least = i;
+        }
+        top[least].vtable = vtable;
+        top[least].type = type;
+        top[least].count++;
+#else
+        (void)vtable; (void)type;
+#endif
+    }
+
+    unsigned long long hit_count() const { return hits; }
+    unsigned long long miss_count() const { return misses; }
+
+    // the most frequent type (TC_DYN_PROFILE only, null otherwise)
+    entry const * dominant() const {
+        entry const * res = nullptr;
+        for (int i = 0; i < tracked; i++) {
+            if (top[i].count && (!res || top[i].count > res->count)) res = &top[i];
+        }
+        return res;
+    }
+
+    void report(std::FILE * out = stderr) const {
+        unsigned long long calls = hits + misses;
+        std::fprintf(out, "%s: %llu calls, %llu hits (%.1f%%), %llu misses\n", name, 
+            calls, hits, calls ? 100.0 * hits / calls : 0.0, misses);
+        for (int i = 0; i < tracked; i++) {
+            if (top[i].count) {
+                std::fprintf(out, "    ~%llu %s\n", top[i].count, top[i].type);
+            }
+        }
+    }
+};
+
+// the speculative calls of TC's methods, see TC_DYN
+template<template<class> class TC, class T>
+using tc_speculate_t = typename _tc_dyn_vtable_<TC>::template _tc_speculate_<T>;
+
+#ifdef TC_DYN_PROFILE
+#define _TC_DYN_NAME_FIELD char const * _tc_type_name_;
+#define _TC_DYN_NAME_INIT vt._tc_type_name_ = tc_type_name<T>();
+#define _TC_DYN_NAME_OF(vt) (vt)->_tc_type_name_
+#else
+#define _TC_DYN_NAME_FIELD
+#define _TC_DYN_NAME_INIT
+#define _TC_DYN_NAME_OF(vt) nullptr
+#endif
+
+
+// TC_DYN(tc, methods): `methods` is a macro taking a macro `m` and 
+// applying it to every method as m(name, signature without self)
+
+#define _TC_DYN_FIELD(name, sig) \
+    typename _tc_dyn_fn_< sig >::type name;
+
+#define _TC_DYN_THUNK(name, sig) \
+    template<class T, class R, class... Args> \
+    static R _tc_thunk_##name(void const * self, Args... args) { \
+        return tc_impl_t<_tc_class_<T>>::name( \
+            *static_cast<T const *>(self), std::forward<Args>(args)...); \
+    }
+
+#define _TC_DYN_INIT(name, sig) \
+    vt.name = &_tc_thunk_##name<T>;
+
+#define _TC_DYN_FORWARD(name, sig) \
+    template<class... Args> \
+    static decltype(auto) name(_tc_dyn_self_ const & x, Args && ... args) { \
+        return x.vtable()->name(x.get(), std::forward<Args>(args)...); \
+    }
+
+// a guarded direct call of the instance of T, the indirect call otherwise
+// (with a site: counted)
+#define _TC_DYN_SPECULATE(name, sig) \
+    template<class Dyn, class... Args, \
+             class = decltype(std::declval<Dyn const &>().vtable())> \
+    static typename _tc_dyn_ret_< sig >::type name(Dyn const & x, Args && ... args) { \
+        if (x.vtable() == _tc_table_of_<T>()) \
+            return tc_impl_t<_tc_class_<T>>::name( \
+                *static_cast<T const *>(x.get()), std::forward<Args>(args)...); \
+        return x.vtable()->name(x.get(), std::forward<Args>(args)...); \
+    } \
+    \
+    template<class Dyn, class... Args> \
+    static typename _tc_dyn_ret_< sig >::type name(tc_dyn_site & site, Dyn const & x, \
+                                                  Args && ... args) { \
+        bool hit = x.vtable() == _tc_table_of_<T>(); \
+        site.record(x.vtable(), _TC_DYN_NAME_OF(x.vtable()), hit); \
+        if (hit) \
+            return tc_impl_t<_tc_class_<T>>::name( \
+                *static_cast<T const *>(x.get()), std::forward<Args>(args)...); \
+        return x.vtable()->name(x.get(), std::forward<Args>(args)...); \
+    }
+
+#define TC_DYN(tc, methods) \
+    template<> struct _tc_dyn_vtable_<tc> { \
+        template<class T> using _tc_class_ = tc<T>; \
+        \
+        void (*drop)(void *);    /* destroy and free (tc_dyn) */ \
+        void (*destroy)(void *); /* only destroy, null if trivial (tc_dyn_in) */ \
+        _TC_DYN_NAME_FIELD \
+        methods(_TC_DYN_FIELD) \
+        \
+        template<class T> \
+        static void _tc_drop_(void * self) { delete static_cast<T *>(self); } \
+        template<class T> \
+        static void _tc_destroy_(void * self) { static_cast<T *>(self)->~T(); } \
+        methods(_TC_DYN_THUNK) \
+        \
+        template<class T> \
+        static constexpr _tc_dyn_vtable_ make() { \
+            _tc_dyn_vtable_ vt{}; \
+            vt.drop = &_tc_drop_<T>; \
+            vt.destroy = std::is_trivially_destructible<T>::value ? \
+                nullptr : &_tc_destroy_<T>; \
+            _TC_DYN_NAME_INIT \
+            methods(_TC_DYN_INIT) \
+            return vt; \
+        } \
+        \
+        template<class T> \
+        static _tc_dyn_vtable_ const * _tc_table_of_() { \
+            return &_tc_dyn_table_<tc, T>::value; \
+        } \
+        \
+        template<class T> \
+        struct _tc_speculate_ { methods(_TC_DYN_SPECULATE) }; \
+    }; \
+    \
+    template<> TC_INSTANCE(tc<tc_dyn<tc>>, { \
+        typedef tc_dyn<tc> _tc_dyn_self_; \
+        methods(_TC_DYN_FORWARD) \
+    }); \
+    \
+    template<> TC_INSTANCE(tc<tc_dyn_in<tc>>, { \
+        typedef tc_dyn_in<tc> _tc_dyn_self_; \
+        methods(_TC_DYN_FORWARD) \
+    }); \
+    \
+    template<> TC_INSTANCE(tc<tc_dyn_ref<tc>>, { \
+        typedef tc_dyn_ref<tc> _tc_dyn_self_; \
+        methods(_TC_DYN_FORWARD) \
+    });
+
+#endif // _TC_DYN_HPP_
@@ -0,0 +1,348 @@
+// ------------------------------------------ //
+//    Call counters for the methods of        //
+//    instances of tc.hpp                     //
+// ------------------------------------------ //
+//
+// Included by tc_macros.hpp when TC_INSTRUMENT is defined before
+// including tc.hpp. Otherwise TC_PROBE() expands to nothing and the
+// generated code is unchanged (see bench/instrument_codegen.cpp).
+//
+// An instance is selected by defining it with TC_INSTANCE_PROBED instead
+// of TC_INSTANCE, with the list of its methods (an X-macro, the same as
+// for TC_DYN of tc_dyn.hpp): each listed method called through tc_impl_t
+// counts its calls, keyed by "<instance type>::<method>". The listed
+// methods are wrapped by forwarding templates, so they can't be constexpr
+// nor have their address taken (TC_OVERRIDES). Without TC_INSTRUMENT,
+// TC_INSTANCE_PROBED is TC_INSTANCE.
+//
+// TC_PROBE() at the beginning of a single method counts its calls, keyed
+// the same way: the instance type and the method name are parsed out of
+// __PRETTY_FUNCTION__ (with gcc and clang; with another compiler the key
+// is the whole signature).
+//
+// With TC_INSTRUMENT_TIMING the time spent in the methods is measured
+// too, in TSC ticks on x86 and in nanoseconds elsewhere.
+//
+// The counters are thread-local (no atomic read-modify-write on the
+// hot path) and are merged into a global table when a thread exits.
+// The report (stderr, at exit, or tc_probe_report on demand) sums
+// the table and the counters of the running threads.
+//
+// Requirements: C++11. A probe can't be used in a constexpr method.
+//
+// Usage example:
+//
+// #define TC_INSTRUMENT
+// #include "tc.hpp"
+//
+// #define SHOW_METHODS(m) m(show, std::string())
+//
+// template<>
+// TC_INSTANCE_PROBED(Show<int>, SHOW_METHODS, {
+//     static std::string show(int const & x) {
+//         return std::to_string(x);
+//     }
+// });
+//
+// template<>
+// TC_INSTANCE(Show<char>, {
+//     static std::string show(char const & x) {
+//         TC_PROBE();
+//         return std::string(1, x);
+//     }
+// });
+//
+
+#ifndef _TC_INSTRUMENT_HPP_
+#define _TC_INSTRUMENT_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+#include "tc_type_name.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#ifdef TC_INSTRUMENT_TIMING
+#define _TC_PROBE_TIMING 1
+#else
+#define _TC_PROBE_TIMING 0
+#endif
+
+inline unsigned long long tc_probe_ticks() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+struct tc_probe_stats {
+    unsigned long long calls;
+    unsigned long long ticks;
+};
+
+struct _tc_probe_local_;
+
+// the counters of the exited threads and the list of the live ones
+class _tc_probe_registry_ {
+    std::mutex m;
+    std::map<std::string, tc_probe_stats> exited;
+    std::vector<_tc_probe_local_ *> live;
+
+    _tc_probe_registry_() {}
+
+public:
+    // never destroyed: thread-local counters may outlive static objects
+    static _tc_probe_registry_ & get() {
+        static _tc_probe_registry_ * r = new _tc_probe_registry_();
+        return *r;
+    }
+
+    void enter(_tc_probe_local_ * local);
+    void leave(_tc_probe_local_ * local);
+
+    std::map<std::string, tc_probe_stats> snapshot();
+};
+
+// the report at exit (disabled with TC_INSTRUMENT_NO_REPORT), after
+// the thread-local counters of the main thread have been merged
+struct _tc_probe_report_at_exit_ {
+    ~_tc_probe_report_at_exit_();
+};
+
+template<class = void>
+struct _tc_probe_report_holder_ {
+    static _tc_probe_report_at_exit_ value;
+};
+
+template<class T>
+_tc_probe_report_at_exit_ _tc_probe_report_holder_<T>::value;
+
+// the counters of a probe in a thread
+struct _tc_probe_local_ {
+    std::string name;
+    std::atomic<unsigned long long> calls;
+    std::atomic<unsigned long long> ticks;
+
+    explicit _tc_probe_local_(std::string name): name(name), calls(0), ticks(0) {
+        _tc_probe_registry_::get().enter(this);
+#ifndef TC_INSTRUMENT_NO_REPORT
+        (void)&_tc_probe_report_holder_<>::value;
+#endif
+    }
+
+    ~_tc_probe_local_() { _tc_probe_registry_::get().leave(this); }
+
+    // only the owning thread writes: a plain load and store
+    static void bump(std::atomic<unsigned long long> & c, unsigned long long n) {
+        c.store(c.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+};
+
+inline void _tc_probe_registry_::enter(_tc_probe_local_ * local) {
+    std::lock_guard<std::mutex> lock(m);
+    live.push_back(local);
+}
+
+inline void _tc_probe_registry_::leave(_tc_probe_local_ * local) {
+    std::lock_guard<std::mutex> lock(m);
+    tc_probe_stats & s = exited[local->name];
+    s.calls += local->calls.load(std::memory_order_relaxed);
+    s.ticks += local->ticks.load(std::memory_order_relaxed);
+    for (std::size_t i = 0; i < live.size(); i++) {
+        if (live[i] == local) { live.erase(live.begin() + i); break; }
+    }
+}
+
+inline std::map<std::string, tc_probe_stats> _tc_probe_registry_::snapshot() {
+    std::lock_guard<std::mutex> lock(m);
+    std::map<std::string, tc_probe_stats> res = exited;
+    for (std::size_t i = 0; i < live.size(); i++) {
+        tc_probe_stats & s = res[live[i]->name];
+        s.calls += live[i]->calls.load(std::memory_order_relaxed);
+        s.ticks += live[i]->ticks.load(std::memory_order_relaxed);
+    }
+    return res;
+}
+
+// counts a call (and its time with TC_INSTRUMENT_TIMING)
+class _tc_probe_guard_ {
+    _tc_probe_local_ & local;
+#if _TC_PROBE_TIMING
+    unsigned long long start;
+#endif
+
+public:
+    explicit _tc_probe_guard_(_tc_probe_local_ & local): local(local) {
+        _tc_probe_local_::bump(local.calls, 1);
+#if _TC_PROBE_TIMING
+        start = tc_probe_ticks();
+#endif
+    }
+
+    ~_tc_probe_guard_() {
+#if _TC_PROBE_TIMING
+        _tc_probe_local_::bump(local.ticks, tc_probe_ticks() - start);
+#endif
+    }
+};
+
+
+// the counters of all the probes (all the threads)
+inline std::map<std::string, tc_probe_stats> tc_probe_snapshot() {
+    return _tc_probe_registry_::get().snapshot();
+}
+
+inline void tc_probe_report(std::FILE * out = stderr) {
+    std::map<std::string, tc_probe_stats> s = tc_probe_snapshot();
+    if (s.empty()) return;
+
+    std::fprintf(out, "%12s %14s %10s  %s\n", "calls", "ticks", "ticks/call", "method");
+    for (std::map<std::string, tc_probe_stats>::const_iterator i = s.begin(); i != s.end(); ++i) {
+        std::fprintf(out, "%12llu %14llu %10.1f  %s\n", i->second.calls, i->second.ticks,
+            i->second.calls ? double(i->second.ticks) / i->second.calls : 0.0, i->first.c_str());
+    }
+}
+
+inline _tc_probe_report_at_exit_::~_tc_probe_report_at_exit_() {
+    tc_probe_report();
+}
+
+// the type in the signature `sig` of a function template of T
+inline std::string _tc_probe_type_name_(char const * sig) {
+    _tc_type_name_range_ r(sig);
+    std::string res;
+    for (std::size_t i = r.begin; i < r.end; i++) {
+        if (!_tc_type_name_skip_(sig, i)) res += sig[i];
+    }
+    return res;
+}
+
+// "Show<int>::show"
+template<class T>
+std::string _tc_probe_key_(char const * method) {
+    return _tc_probe_type_name_(_tc_type_signature_<T>()) + "::" + method;
+}
+
+inline bool _tc_probe_ident_char_(char c) {
+    return c == '_' || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9');
+}
+
+// `s` with the identifier `name` replaced by `value`
+inline std::string _tc_probe_substitute_(std::string const & s, std::string const & name,
+                                         std::string const & value) {
+    std::string res;
+    for (std::size_t i = 0; i < s.size(); ) {
+        if (s.compare(i, name.size(), name) == 0
+            && (i == 0 || !_tc_probe_ident_char_(s[i - 1]))
+            && (i + name.size() == s.size() || !_tc_probe_ident_char_(s[i + name.size()]))) {
+            res += value;
+            i += name.size();
+        } else {
+            res += s[i++];
+        }
+    }
+    return res;
+}
+
+// "Show<std::vector<int>>::show" out of the signature of a method of an
+// instance, spelled by gcc "static std::string _tc_impl_<Show<std::vector<T> >
+// >::<unnamed struct>::show(const std::vector<T>&) [with T = int; ...]" (and
+// the same way by clang), or the whole signature if the compiler spells
+// it differently
+inline std::string _tc_probe_method_key_(char const * sig) {
+    std::string s = sig;
+
+    // the template arguments "[with T = int; U = char]" (gcc) or "[T = int]" (clang)
+    std::string with;
+    std::size_t last = s.size();
+    std::size_t open = s.rfind(" [");
+    if (open != std::string::npos && !s.empty() && s[s.size() - 1] == ']'
+        && s.find(" = ", open) != std::string::npos) {
+        with = s.substr(open + 2, s.size() - open - 3);
+        if (with.compare(0, 5, "with ") == 0) with.erase(0, 5);
+        last = open;
+    }
+
+    // the instance: the first argument of _tc_impl_
+    std::size_t impl = s.find("_tc_impl_<");
+    if (impl == std::string::npos) return s;
+    std::size_t begin = impl + 10, end = begin;
+    for (int depth = 0; end < last; end++) {
+        char c = s[end];
+        if (c == '<' || c == '(') depth++;
+        else if ((c == '>' || c == ')') && depth > 0) depth--;
+        else if ((c == '>' || c == ',') && depth == 0) break;
+    }
+    if (end >= last) return s;
+    std::string instance = s.substr(begin, end - begin);
+
+    // the method: the name before the parameter list, the last (...)
+    std::size_t params = s.rfind(')', last);
+    if (params == std::string::npos || params < end) return s;
+    for (int depth = 0; ; params--) {
+        if (s[params] == ')') depth++;
+        else if (s[params] == '(' && --depth == 0) break;
+        if (params == end) return s;
+    }
+    std::size_t scope = s.rfind("::", params);
+    if (scope == std::string::npos || scope < end) return s;
+    std::string method = s.substr(scope + 2, params - scope - 2);
+
+    // the template parameters of a partial specialization
+    for (std::size_t i = 0; i < with.size(); ) {
+        std::size_t next = with.find("; ", i);
+        if (next == std::string::npos) next = with.size();
+        std::string arg = with.substr(i, next - i);
+        std::size_t eq = arg.find(" = ");
+        if (eq != std::string::npos) {
+            instance = _tc_probe_substitute_(instance, arg.substr(0, eq), arg.substr(eq + 3));
+        }
+        i = next + 2;
+    }
+
+    std::string key;
+    for (std::size_t i = 0; i < instance.size(); i++) {
+        if (!_tc_type_name_skip_(instance.c_str(), i)) key += instance[i];
+    }
+    while (!key.empty() && key[key.size() - 1] == ' ') key.erase(key.size() - 1);
+    return key + "::" + method;
+}
+
+#define TC_PROBE() \
+    static thread_local _tc_probe_local_ _tc_probe_local_at_( \
+        _tc_probe_method_key_(_TC_PRETTY_FUNCTION)); \
+    _tc_probe_guard_ _tc_probe_guard_at_(_tc_probe_local_at_)
+
+
+// the instance is `_tc_unprobed_`, `type` forwards the listed methods to it
+#define TC_INSTANCE_PROBED(tc, methods, body...) \
+    struct _tc_impl_< tc > { \
+        typedef struct: tc body _tc_unprobed_; \
+        struct type: _tc_unprobed_ { \
+            typedef tc _tc_probed_class_; \
+            methods(_TC_PROBE_METHOD) \
+        }; \
+    };
+
+#define _TC_PROBE_METHOD(method, signature) \
+    template<class... _tc_args_> \
+    static auto method(_tc_args_ &&... args) \
+        -> decltype(_tc_unprobed_::method(std::forward<_tc_args_>(args)...)) \
+    { \
+        static thread_local _tc_probe_local_ _tc_probe_local_at_( \
+            _tc_probe_key_<_tc_probed_class_>(#method)); \
+        _tc_probe_guard_ _tc_probe_guard_at_(_tc_probe_local_at_); \
+        return _tc_unprobed_::method(std::forward<_tc_args_>(args)...); \
+    }
+
+#endif // _TC_INSTRUMENT_HPP_
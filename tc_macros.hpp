@@ -0,0 +1,58 @@
+// The macros of tc.hpp.
+//
+// Normally this header is included by tc.hpp. It can be included alone 
+// after importing the C++20 module `tc` which exports the templates 
+// the macros refer to (_tc_impl_, tc_impl_t, _tc_dummy_, tc_require_t).
+
+#ifndef _TC_MACROS_HPP_
+#define _TC_MACROS_HPP_
+
+#define TC_INSTANCE(tc, body...) \
+    struct _tc_impl_< tc > { typedef struct: tc body type; };
+
+#define TC_IMPL(tc...) typedef typename _tc_impl_< tc >::type
+
+// wrap the first argument to the TC_INSTANCE macro if it contains commas
+#define TC(x...) x
+// a somewhat uglier alternative is to #define COMMA ,
+
+
+#if __cplusplus >= 201103L
+
+// a mechanism for putting constraints on instantiations or definitions
+#define TC_REQUIRE(tc...) \
+    static_assert( _tc_dummy_<tc_impl_t<tc>>::value, "unreachable" );
+
+// a constrained instance, declared only if the condition is void:
+//
+// template<class T>
+// TC_INSTANCE_IF(MyClass< MyType<T> >, tc_require_t<MyClass<T>>, {
+//     ...
+// })
+#define TC_INSTANCE_IF(tc, cond, body...) \
+    struct _tc_impl_< tc, cond > { typedef struct: tc body type; };
+
+// true if the instance defines the method instead of inheriting 
+// the default one from the typeclass (a constant expression):
+//
+// static_assert(TC_OVERRIDES(foo, MyClass<T>) || TC_OVERRIDES(bar, MyClass<T>),
+//               "MyClass: define foo or bar");
+//
+// The method must be neither overloaded, nor a template, nor deleted.
+#define TC_OVERRIDES(method, tc...) \
+    ( &tc_impl_t< tc >::method != &tc::method )
+
+#endif // c++11
+
+
+// TC_PROBE() in a method of an instance, or TC_INSTANCE_PROBED(tc, methods, 
+// body) in place of TC_INSTANCE, counts calls when TC_INSTRUMENT is defined 
+// (see tc_instrument.hpp); otherwise they expand to nothing and to TC_INSTANCE
+#ifdef TC_INSTRUMENT
+#include "tc_instrument.hpp"
+#else
+#define TC_PROBE()
+#define TC_INSTANCE_PROBED(tc, methods, body...) TC_INSTANCE(TC(tc), body)
+#endif
+
+#endif // _TC_MACROS_HPP_
@@ -0,0 +1,100 @@
+// ------------------------------------------ //
+//    Readable type names for the reports     //
+//    of tc_dyn.hpp and tc_instrument.hpp     //
+// ------------------------------------------ //
+//
+// The name of a type T is taken from the signature of a function
+// template (__PRETTY_FUNCTION__), which gcc spells
+// "... [with T = Square]" and clang "... [T = Square]": the part after
+// "T = ", with "> >" spelled ">>". With another compiler the whole
+// signature is kept.
+//
+// Requirements: C++11, C++14 for tc_type_name.
+//
+// Usage example:
+//
+// std::puts(tc_type_name<std::vector<int>>()); // "std::vector<int>"
+//
+
+#ifndef _TC_TYPE_NAME_HPP_
+#define _TC_TYPE_NAME_HPP_
+
+#include <cstddef>
+
+#if defined(_MSC_VER)
+#define _TC_PRETTY_FUNCTION __FUNCSIG__
+#else
+#define _TC_PRETTY_FUNCTION __PRETTY_FUNCTION__
+#endif
+
+// "... [with T = Square]"
+template<class T>
+constexpr char const * _tc_type_signature_() { return _TC_PRETTY_FUNCTION; }
+
+constexpr std::size_t _tc_type_name_length_(char const * s, std::size_t i = 0) {
+    return s[i] ? _tc_type_name_length_(s, i + 1) : i;
+}
+
+// the position after "T = ", or 0 if there is none
+constexpr std::size_t _tc_type_name_begin_(char const * s, std::size_t i = 0) {
+    return !s[i] ? 0
+         : s[i] == 'T' && s[i + 1] == ' ' && s[i + 2] == '=' && s[i + 3] == ' ' ? i + 4
+         : _tc_type_name_begin_(s, i + 1);
+}
+
+// the position of the last ']', or the end of the signature
+constexpr std::size_t _tc_type_name_end_(char const * s, std::size_t i) {
+    return i == 0 ? _tc_type_name_length_(s)
+         : s[i - 1] == ']' ? i - 1
+         : _tc_type_name_end_(s, i - 1);
+}
+
+// the space of "> >", left out of the name
+constexpr bool _tc_type_name_skip_(char const * s, std::size_t i) {
+    return s[i] == ' ' && i > 0 && s[i - 1] == '>' && s[i + 1] == '>';
+}
+
+// [begin, end) of the type in the signature `s` of a function template
+// of T (the whole signature if the compiler spells it differently)
+struct _tc_type_name_range_ {
+    std::size_t begin, end;
+
+    constexpr explicit _tc_type_name_range_(char const * s)
+        : begin(_tc_type_name_begin_(s))
+        , end(begin ? _tc_type_name_end_(s, _tc_type_name_length_(s))
+                    : _tc_type_name_length_(s)) {}
+};
+
+
+#if __cplusplus >= 201402L
+
+template<class T>
+struct _tc_type_name_ {
+    static constexpr std::size_t size = _tc_type_name_length_(_tc_type_signature_<T>()) + 1;
+
+    struct chars { char s[size]; };
+
+    static constexpr chars make() {
+        char const * sig = _tc_type_signature_<T>();
+        _tc_type_name_range_ r(sig);
+        chars res{};
+        std::size_t n = 0;
+        for (std::size_t i = r.begin; i < r.end; i++) {
+            if (!_tc_type_name_skip_(sig, i)) res.s[n++] = sig[i];
+        }
+        return res;
+    }
+
+    static constexpr chars value = make();
+};
+
+template<class T>
+constexpr typename _tc_type_name_<T>::chars _tc_type_name_<T>::value;
+
+// the name of T (a constant expression)
+template<class T>
+constexpr char const * tc_type_name() { return _tc_type_name_<T>::value.s; }
+
+#endif // c++14
+
+#endif // _TC_TYPE_NAME_HPP_